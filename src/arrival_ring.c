@@ -0,0 +1,88 @@
+#include "arrival_ring.h"
+
+arrival_ring_t *arrival_ring_create(key_t key, uint32_t capacity)
+{
+    uint32_t slots = 1;
+    while (slots < capacity)
+        slots <<= 1;
+
+    // a segment left over by an earlier run may have another size
+    arrival_ring_destroy(key);
+    int shmid = shmget(key, sizeof(arrival_ring_t) + slots * sizeof(process_info_t), IPC_CREAT | 0666);
+    if (shmid == -1)
+    {
+        perror("Error in creating the arrival ring");
+        return NULL;
+    }
+    arrival_ring_t *ring = (arrival_ring_t *)shmat(shmid, NULL, 0);
+    if ((long)ring == -1)
+    {
+        perror("Error in attaching the arrival ring");
+        return NULL;
+    }
+
+    ring->head = 0;
+    ring->tail = 0;
+    __atomic_store_n(&ring->capacity, slots, __ATOMIC_RELEASE);
+    return ring;
+}
+
+arrival_ring_t *arrival_ring_attach(key_t key)
+{
+    int shmid = shmget(key, 0, 0666);
+    if (shmid == -1)
+        return NULL;
+    arrival_ring_t *ring = (arrival_ring_t *)shmat(shmid, NULL, 0);
+    if ((long)ring == -1)
+        return NULL;
+    return ring;
+}
+
+size_t arrival_ring_push(arrival_ring_t *ring, const process_info_t *processes, size_t count)
+{
+    uint64_t head = ring->head;
+    uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    size_t room = ring->capacity - (head - tail);
+    if (count > room)
+        count = room;
+
+    for (size_t i = 0; i < count; i++)
+        ring->slots[(head + i) & (ring->capacity - 1)] = processes[i];
+
+    // publish the slots before the new head
+    __atomic_store_n(&ring->head, head + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+size_t arrival_ring_pop(arrival_ring_t *ring, process_info_t *processes, size_t max_count)
+{
+    uint64_t tail = ring->tail;
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    size_t count = head - tail;
+    if (count > max_count)
+        count = max_count;
+
+    for (size_t i = 0; i < count; i++)
+        processes[i] = ring->slots[(tail + i) & (ring->capacity - 1)];
+
+    // hand the slots back to the producer only once they are copied
+    __atomic_store_n(&ring->tail, tail + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+size_t arrival_ring_size(arrival_ring_t *ring)
+{
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+void arrival_ring_detach(arrival_ring_t *ring)
+{
+    shmdt(ring);
+}
+
+void arrival_ring_destroy(key_t key)
+{
+    int shmid = shmget(key, 0, 0666);
+    if (shmid != -1)
+        shmctl(shmid, IPC_RMID, NULL);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "header.h"
+
+#define ARRIVAL_RING_SHKEY 500
+#define ARRIVAL_RING_CAPACITY (1 << 16) /* slots, must be a power of two */
+#define ARRIVAL_RING_CACHE_LINE 64
+
+/**
+ * struct arrival_ring_s - Single-producer/single-consumer ring of arrivals in shared memory
+ * @capacity: number of slots, a power of two
+ * @head: total number of processes pushed, only written by the producer
+ * @tail: total number of processes popped, only written by the consumer
+ * @slots: the processes, slot i % capacity
+ *
+ * Description: The generator pushes and the scheduler pops without locks or
+ *              syscalls. @head and @tail live on separate cache lines so the
+ *              two sides do not invalidate each other's line on every update.
+ */
+typedef struct arrival_ring_s
+{
+    uint32_t capacity;
+    volatile uint64_t head __attribute__((aligned(ARRIVAL_RING_CACHE_LINE)));
+    volatile uint64_t tail __attribute__((aligned(ARRIVAL_RING_CACHE_LINE)));
+    process_info_t slots[] __attribute__((aligned(ARRIVAL_RING_CACHE_LINE)));
+} arrival_ring_t;
+
+/**
+ * arrival_ring_create - creates the shared memory segment of the ring and attaches it.
+ * @param key: the SysV key of the segment.
+ * @param capacity: number of slots, rounded up to a power of two.
+ * @return the attached ring, or NULL on failure.
+ */
+arrival_ring_t *arrival_ring_create(key_t key, uint32_t capacity);
+
+/**
+ * arrival_ring_attach - attaches a ring created by arrival_ring_create().
+ * @param key: the SysV key of the segment.
+ * @return the attached ring, or NULL if it does not exist.
+ */
+arrival_ring_t *arrival_ring_attach(key_t key);
+
+/**
+ * arrival_ring_push - copies processes into the ring, producer side.
+ * @param ring: the ring.
+ * @param processes: the processes to push.
+ * @param count: number of processes.
+ * @return the number of processes pushed, less than @count once the ring is full.
+ */
+size_t arrival_ring_push(arrival_ring_t *ring, const process_info_t *processes, size_t count);
+
+/**
+ * arrival_ring_pop - copies processes out of the ring, consumer side.
+ * @param ring: the ring.
+ * @param processes: where to store them.
+ * @param max_count: room in @processes.
+ * @return the number of processes popped, 0 if the ring is empty.
+ */
+size_t arrival_ring_pop(arrival_ring_t *ring, process_info_t *processes, size_t max_count);
+
+/**
+ * arrival_ring_size - number of processes pushed but not popped yet.
+ * @param ring: the ring.
+ */
+size_t arrival_ring_size(arrival_ring_t *ring);
+
+/**
+ * arrival_ring_detach - detaches the ring, the last one to detach after
+ *                       arrival_ring_destroy() frees the segment.
+ * @param ring: the ring.
+ */
+void arrival_ring_detach(arrival_ring_t *ring);
+
+/**
+ * arrival_ring_destroy - marks the segment of the ring for removal.
+ * @param key: the SysV key of the segment.
+ */
+void arrival_ring_destroy(key_t key);
@@ -6,43 +6,241 @@
  */
 
 #include "clk.h"
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#define LATENESS_BUCKETS 64 /* bucket i counts lateness in [2^(i-1), 2^i) ns */
+#define LATE_TICK_FRACTION 10 /* a tick is late once it is a tenth of a period behind */
 
 int shmid;
+int64_t lateness_hist[LATENESS_BUCKETS];
+int64_t lateness_max;
+int64_t ticks_measured;
+int64_t late_ticks;
+
+void dumpJitter();
 
 /* Clear the resources before exit */
 void cleanup(int signum)
 {
     (void)signum;
     shmctl(shmid, IPC_RMID, NULL);
+    dumpJitter();
     printf("Clock terminating!\n");
     exit(0);
 }
 
+/*
+ * Parses a tick period such as "500ms", "250us" or "1s", a bare number is in nanoseconds.
+ * Returns -1 if the period is malformed or outside [CLK_MIN_TICK_NS, CLK_MAX_TICK_NS].
+ */
+int64_t parseTickPeriod(const char *period)
+{
+    char *unit;
+    long long value = strtoll(period, &unit, 10);
+    int64_t scale;
+
+    if (unit == period || value <= 0)
+        return -1;
+    if (*unit == '\0' || strcmp(unit, "ns") == 0)
+        scale = 1;
+    else if (strcmp(unit, "us") == 0)
+        scale = 1000;
+    else if (strcmp(unit, "ms") == 0)
+        scale = 1000000;
+    else if (strcmp(unit, "s") == 0)
+        scale = 1000000000;
+    else
+        return -1;
+
+    if (value > CLK_MAX_TICK_NS / scale || value * scale < CLK_MIN_TICK_NS)
+        return -1;
+    return value * scale;
+}
+
+/* Adds the lateness of one tick, in nanoseconds, to the jitter histogram */
+void recordLateness(int64_t lateness, int64_t tick_ns)
+{
+    int bucket = 0;
+    if (lateness < 0)
+        lateness = 0;
+    while (bucket < LATENESS_BUCKETS - 1 && (1LL << bucket) <= lateness)
+        bucket++;
+    lateness_hist[bucket]++;
+    ticks_measured++;
+    if (lateness > lateness_max)
+        lateness_max = lateness;
+    if (lateness > tick_ns / LATE_TICK_FRACTION)
+        late_ticks++;
+}
+
+/* Upper bound, in nanoseconds, of the lateness below which the given permille of ticks fall */
+int64_t latenessPercentile(int permille)
+{
+    int64_t wanted = (ticks_measured * permille + 999) / 1000;
+    int64_t seen = 0;
+    for (int i = 0; i < LATENESS_BUCKETS; i++)
+    {
+        seen += lateness_hist[i];
+        if (seen >= wanted)
+            return i == 0 ? 0 : ((1LL << i) - 1 < lateness_max ? (1LL << i) - 1 : lateness_max);
+    }
+    return lateness_max;
+}
+
+/* Print how late the real-time ticks were, so an overloaded host can be spotted */
+void dumpJitter()
+{
+    if (ticks_measured == 0)
+        return;
+    printf("Clock ticks %lld, late %lld (more than 1/%d tick)\n",
+           (long long)ticks_measured, (long long)late_ticks, LATE_TICK_FRACTION);
+    printf("Tick lateness p50 <= %.3fms p99 <= %.3fms max = %.3fms\n",
+           latenessPercentile(500) / 1e6, latenessPercentile(990) / 1e6, lateness_max / 1e6);
+    for (int i = 0; i < LATENESS_BUCKETS; i++)
+    {
+        if (lateness_hist[i] == 0)
+            continue;
+        printf("  < %12lldns: %lld\n", i == LATENESS_BUCKETS - 1 ? (long long)INT64_MAX : 1LL << i,
+               (long long)lateness_hist[i]);
+    }
+}
+
+/* Publish a new tick and wake everyone blocked on the clock */
+void publishTick(clk_page_t *page, int64_t ticks)
+{
+    page->ticks = ticks;
+    page->tick_stamp_ns = monotonicNs();
+    __sync_synchronize();
+    futexWakeClk(&page->tick_seq);
+    futexWakeClk(&page->event_seq);
+}
+
+/*
+ * Advance one tick every tick period of wall time. Every tick has an absolute
+ * deadline measured from the epoch, so a late wake up does not push the later
+ * ticks back and the clock never drifts behind wall time.
+ */
+void runRealTime(clk_page_t *page)
+{
+    while (1)
+    {
+        int64_t deadline = page->epoch_ns + (page->ticks + 1) * page->tick_ns;
+        struct timespec wake = {
+            .tv_sec = deadline / 1000000000LL,
+            .tv_nsec = deadline % 1000000000LL,
+        };
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR)
+            ;
+        publishTick(page, page->ticks + 1);
+        recordLateness(page->tick_stamp_ns - deadline, page->tick_ns);
+    }
+}
+
+/* Returns the earliest event after the current tick, or CLK_NO_EVENT */
+int64_t nextVirtualEvent(clk_page_t *page)
+{
+    int64_t next = CLK_NO_EVENT;
+    for (int i = 0; i < CLK_PARTICIPANTS; i++)
+    {
+        int64_t event = page->next[i];
+        if (event > page->ticks && (next == CLK_NO_EVENT || event < next))
+            next = event;
+    }
+    return next;
+}
+
+/* Jump to the next pending event once every participant is done with the current tick */
+void runVirtualTime(clk_page_t *page)
+{
+    while (1)
+    {
+        // read the event counter first, an acknowledgement after it wakes the wait
+        uint32_t seen = page->event_seq;
+        bool handled = true;
+        for (int i = 0; i < CLK_PARTICIPANTS; i++)
+            handled = handled && page->ack[i] >= page->ticks;
+
+        __sync_synchronize();
+        int64_t next = nextVirtualEvent(page);
+        if (!handled || next == CLK_NO_EVENT)
+        {
+            futexWaitClk(&page->event_seq, seen);
+            continue;
+        }
+        publishTick(page, next);
+    }
+}
+
 /* This file represents the system clock for ease of calculations */
 int main(int argc, char * argv[])
 {
-    (void)argc;
-    (void)argv;
-    printf("Clock starting\n");
+    clk_mode mode = CLK_REAL_TIME;
+    int64_t tick_ns = CLK_DEFAULT_TICK_NS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "vt:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'v':
+            mode = CLK_VIRTUAL_TIME;
+            break;
+        case 't':
+            tick_ns = parseTickPeriod(optarg);
+            if (tick_ns == -1)
+            {
+                printf("Invalid tick period %s, use 1us to 1s (e.g. 500ms)\n", optarg);
+                exit(-1);
+            }
+            break;
+        default:
+            printf("Use: ./clk [-v] [-t <tick_period>]\n");
+            exit(-1);
+        }
+    }
+
+    printf("Clock starting%s\n", mode == CLK_VIRTUAL_TIME ? " in virtual-time mode" : "");
     signal(SIGINT, cleanup);
-    int clk = 0;
-    //Create shared memory for one integer variable 4 bytes
-    shmid = shmget(SHKEY, 4, IPC_CREAT | 0644);
+    //Create shared memory for the clock page
+    shmid = shmget(SHKEY, sizeof(clk_page_t), IPC_CREAT | 0666);
     if ((long)shmid == -1)
     {
         perror("Error in creating shm!");
         exit(-1);
     }
-    float * shmaddr = (float *) shmat(shmid, (void *)0, 0);
-    if ((long)shmaddr == -1)
+    clk_page_t * page = (clk_page_t *) shmat(shmid, (void *)0, 0);
+    if ((long)page == -1)
     {
         perror("Error in attaching the shm in clock!");
         exit(-1);
     }
-    *shmaddr = clk; /* initialize shared memory */
-    while (1)
+    /* initialize shared memory */
+    page->mode = mode;
+    page->ticks = 0;
+    page->tick_ns = tick_ns;
+    page->proc_acks = 0;
+    page->proc_reports = 0;
+    page->proc_ready = 0;
+    page->tick_seq = 0;
+    page->event_seq = 0;
+    for (int i = 0; i < CLK_PARTICIPANTS; i++)
     {
-        usleep(500*1000);
-        (*shmaddr)+=.5;
+        page->next[i] = CLK_NO_EVENT;
+        page->ack[i] = -1;
     }
+    page->epoch_ns = monotonicNs();
+    page->tick_stamp_ns = page->epoch_ns;
+    page->status_seq = 0;
+    memset(&page->status, 0, sizeof(page->status));
+    page->status.running_id = -1;
+    __sync_synchronize();
+    page->version = CLK_PAGE_VERSION;
+
+    if (mode == CLK_VIRTUAL_TIME)
+        runVirtualTime(page);
+    else
+        runRealTime(page);
 }
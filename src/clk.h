@@ -13,6 +13,11 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <signal.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 typedef short bool;
 #define true 1
@@ -21,20 +26,329 @@ typedef short bool;
 #define SHKEY 300
 #define GUI_SHKEY 400
 
+#define CLK_PAGE_VERSION 4 /* bumped whenever the layout of clk_page_t changes */
+#define CLK_TICKS_PER_UNIT 2 /* processes are switched half way through each time unit */
+#define CLK_DEFAULT_TICK_NS 500000000LL
+#define CLK_MIN_TICK_NS 1000LL
+#define CLK_MAX_TICK_NS 1000000000LL
+#define CLK_NO_EVENT -1 /* a participant has nothing pending */
+#define CLK_DETACHED INT64_MAX /* a participant no longer takes part in the handshake */
+#define CLK_CACHE_LINE 64
+
+/**
+ * clk_mode - How the clock module advances time
+ * @CLK_REAL_TIME: advance one tick every tick period of wall time
+ * @CLK_VIRTUAL_TIME: jump straight to the next pending event once every
+ *                    participant has finished with the current time
+ */
+typedef enum
+{
+    CLK_REAL_TIME = 0,
+    CLK_VIRTUAL_TIME
+} clk_mode;
+
+/**
+ * clk_participant - Modules that drive the virtual clock
+ * @CLK_GENERATOR: the process_generator, it owns the arrival events
+ * @CLK_SCHEDULER: the scheduler, it owns quantum expiries and completions
+ */
+typedef enum
+{
+    CLK_GENERATOR = 0,
+    CLK_SCHEDULER,
+    CLK_PARTICIPANTS
+} clk_participant;
+
+/**
+ * struct clk_status_s - Snapshot of the simulation published by the scheduler
+ * @ticks: clock tick the snapshot was taken at
+ * @running_id: file id of the running process, -1 when the CPU is idle
+ * @ready_count: processes in the ready queue, the running one excluded
+ * @blocked_count: processes waiting for memory
+ * @free_mem: free memory in bytes
+ * @completed: number of finished processes
+ * @wta_sum: sum of the weighted turnaround times of the finished processes
+ * @wta_sq_sum: sum of their squares, for the standard deviation
+ */
+typedef struct clk_status_s
+{
+    int64_t ticks;
+    int running_id;
+    int ready_count;
+    int blocked_count;
+    int free_mem;
+    int completed;
+    double wta_sum;
+    double wta_sq_sum;
+} clk_status_t;
+
+/**
+ * struct clk_page_s - The shared memory segment owned by the clock module
+ * @version: CLK_PAGE_VERSION, written by the clock module once the page is initialized
+ * @mode: how the clock advances, see clk_mode
+ * @ticks: current simulation time in ticks, CLK_TICKS_PER_UNIT ticks make one time unit
+ * @epoch_ns: CLOCK_MONOTONIC time at which tick 0 started
+ * @tick_ns: wall time between two ticks in real-time mode
+ * @next: next event tick published by each participant, or CLK_NO_EVENT
+ * @ack: last tick each participant has finished handling
+ * @proc_acks: number of stop/continue signals handled by process.out instances
+ * @proc_reports: number of time units (slot writes and completions) process.out instances reported
+ * @proc_ready: number of process.out instances that got set up and wait for their first dispatch
+ * @tick_seq: futex word bumped by the clock module after every tick
+ * @event_seq: futex word bumped on every tick, acknowledgement and report
+ * @tick_stamp_ns: CLOCK_MONOTONIC time at which @ticks was last published
+ * @status_seq: seqlock guarding @status, odd while the scheduler is writing it
+ * @status: latest snapshot of the simulation, on its own cache lines
+ *
+ * Description: In real-time mode @ticks follows wall time. In virtual-time mode
+ *              the clock waits until every participant has acknowledged @ticks
+ *              and then jumps to the earliest published @next.
+ *              Readers sleep on @tick_seq instead of polling @ticks, the
+ *              scheduler and the virtual clock sleep on @event_seq.
+ */
+typedef struct clk_page_s
+{
+    volatile uint32_t version;
+    volatile clk_mode mode;
+    volatile int64_t ticks;
+    int64_t epoch_ns;
+    int64_t tick_ns;
+    volatile int64_t next[CLK_PARTICIPANTS];
+    volatile int64_t ack[CLK_PARTICIPANTS];
+    volatile int proc_acks;
+    volatile int proc_reports;
+    volatile int proc_ready;
+    volatile uint32_t tick_seq;
+    volatile uint32_t event_seq;
+    volatile int64_t tick_stamp_ns;
+    volatile uint32_t status_seq __attribute__((aligned(CLK_CACHE_LINE)));
+    clk_status_t status;
+} clk_page_t;
+
+/**
+ * struct clk_latency_s - Delay between a tick being published and a waiter waking up
+ * @count: number of wake ups measured
+ * @total_ns: sum of the measured delays
+ * @max_ns: largest measured delay
+ */
+typedef struct clk_latency_s
+{
+    int64_t count;
+    int64_t total_ns;
+    int64_t max_ns;
+} clk_latency_t;
+
 ///==============================
 // mess with this variable//
-float *shmaddr; //
+clk_page_t *shmaddr; //
 //===============================
+clk_latency_t tick_latency;
 
 
 int getClk()
 {
-    return *shmaddr;
+    return shmaddr->ticks / CLK_TICKS_PER_UNIT;
 }
 
 float getClkFloat()
 {
-    return (float)*shmaddr;
+    return (float)shmaddr->ticks / CLK_TICKS_PER_UNIT;
+}
+
+int64_t getClkTicks()
+{
+    return shmaddr->ticks;
+}
+
+/*
+ * Sleeps on a futex word of the clock page as long as it still holds @seen.
+ * The word lives in a SysV segment shared between processes, so the
+ * non-private futex operations are used.
+ */
+void futexWaitClk(volatile uint32_t *word, uint32_t seen)
+{
+    syscall(SYS_futex, word, FUTEX_WAIT, seen, NULL, NULL, 0);
+}
+
+/*
+ * Bumps a futex word of the clock page and wakes everyone sleeping on it.
+ */
+void futexWakeClk(volatile uint32_t *word)
+{
+    __sync_fetch_and_add(word, 1);
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/* Current CLOCK_MONOTONIC time in nanoseconds */
+int64_t monotonicNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*
+ * Adds the delay between the publication of the current tick and now to tick_latency.
+ */
+void recordTickLatency()
+{
+    int64_t delay = monotonicNs() - shmaddr->tick_stamp_ns;
+    if (delay < 0)
+        delay = 0;
+    tick_latency.count++;
+    tick_latency.total_ns += delay;
+    if (delay > tick_latency.max_ns)
+        tick_latency.max_ns = delay;
+}
+
+/*
+ * Blocks until the clock has moved past the given tick.
+ * Input: ticks: the last tick the caller has seen, usually read with getClkTicks().
+ * Returns the current tick.
+ */
+int64_t waitForTick(int64_t ticks)
+{
+    bool slept = false;
+    while (1)
+    {
+        uint32_t seen = shmaddr->tick_seq;
+        if (shmaddr->ticks != ticks)
+            break;
+        futexWaitClk(&shmaddr->tick_seq, seen);
+        slept = true;
+    }
+    if (slept)
+        recordTickLatency();
+    return shmaddr->ticks;
+}
+
+/*
+ * Blocks until the clock reaches the given time unit.
+ */
+void waitUntil(int time)
+{
+    int64_t ticks = getClkTicks();
+    while (ticks / CLK_TICKS_PER_UNIT < time)
+        ticks = waitForTick(ticks);
+}
+
+/*
+ * Returns the current value of the event counter, pass it to waitForClkEvent()
+ * once the work it covers is done.
+ */
+uint32_t getClkEvents()
+{
+    return shmaddr->event_seq;
+}
+
+/*
+ * Wakes whoever sleeps in waitForClkEvent(), called after signalling the scheduler.
+ */
+void ringClk()
+{
+    futexWakeClk(&shmaddr->event_seq);
+}
+
+/*
+ * Blocks until a tick, acknowledgement or report happened after getClkEvents() returned @seen.
+ * Signals that are not blocked interrupt the wait.
+ */
+void waitForClkEvent(uint32_t seen)
+{
+    int64_t ticks = shmaddr->ticks;
+    if (shmaddr->event_seq != seen)
+        return;
+    futexWaitClk(&shmaddr->event_seq, seen);
+    if (shmaddr->ticks != ticks)
+        recordTickLatency();
+}
+
+/*
+ * Tells whether the clock jumps between events instead of following wall time.
+ */
+bool isVirtualClk()
+{
+    return shmaddr->mode == CLK_VIRTUAL_TIME;
+}
+
+/*
+ * Publishes the next event of a participant, then acknowledges that it is
+ * done with the tick it has just handled. Only meaningful in virtual-time mode.
+ * Input: participant: the module acknowledging.
+ *        handled: the tick the participant has finished with.
+ *        next_event: the next tick it needs the clock at, or CLK_NO_EVENT.
+ */
+void ackClk(clk_participant participant, int64_t handled, int64_t next_event)
+{
+    shmaddr->next[participant] = next_event;
+    __sync_synchronize();
+    shmaddr->ack[participant] = handled;
+    ringClk();
+}
+
+/*
+ * Removes a participant from the virtual-time handshake, the clock will no
+ * longer wait for it.
+ */
+void detachClk(clk_participant participant)
+{
+    ackClk(participant, CLK_DETACHED, CLK_NO_EVENT);
+}
+
+/*
+ * Called by process.out once it has handled a stop/continue signal.
+ */
+void ackClkProcess()
+{
+    __sync_fetch_and_add(&shmaddr->proc_acks, 1);
+    ringClk();
+}
+
+/*
+ * Called by process.out when it reports a time unit to the scheduler, through
+ * its slot or a finish, ringClk() has to follow.
+ */
+void reportClkProcess()
+{
+    __sync_fetch_and_add(&shmaddr->proc_reports, 1);
+}
+
+/*
+ * Called by process.out once it is attached to the clock and can handle a dispatch.
+ */
+void readyClkProcess()
+{
+    __sync_fetch_and_add(&shmaddr->proc_ready, 1);
+    ringClk();
+}
+
+/*
+ * Publishes a snapshot of the simulation, only the scheduler writes it.
+ */
+void publishStatus(const clk_status_t *status)
+{
+    shmaddr->status_seq++;
+    __sync_synchronize();
+    shmaddr->status = *status;
+    __sync_synchronize();
+    shmaddr->status_seq++;
+}
+
+/*
+ * Copies a consistent snapshot of the simulation, retrying while the scheduler
+ * is in the middle of publishing one. Safe to call at any rate from any process.
+ */
+void readStatus(clk_status_t *status)
+{
+    uint32_t seq;
+    do
+    {
+        while ((seq = shmaddr->status_seq) & 1)
+            ;
+        __sync_synchronize();
+        *status = shmaddr->status;
+        __sync_synchronize();
+    } while (shmaddr->status_seq != seq);
 }
 
 /*
@@ -43,15 +357,22 @@ float getClkFloat()
  */
 void initClk()
 {
-    int shmid = shmget(SHKEY, 4, 0444);
+    int shmid = shmget(SHKEY, sizeof(clk_page_t), 0666);
     while ((int)shmid == -1)
     {
         // Make sure that the clock exists
         printf("Wait! The clock not initialized yet!\n");
         sleep(1);
-        shmid = shmget(SHKEY, 4, 0444);
+        shmid = shmget(SHKEY, sizeof(clk_page_t), 0666);
+    }
+    shmaddr = (clk_page_t *)shmat(shmid, (void *)0, 0);
+    while (shmaddr->version == 0)
+        usleep(1000);
+    if (shmaddr->version != CLK_PAGE_VERSION)
+    {
+        printf("Clock page version %u is not supported, expected %u!\n", shmaddr->version, CLK_PAGE_VERSION);
+        exit(-1);
     }
-    shmaddr = (float *)shmat(shmid, (void *)0, 0);
 }
 
 /*
@@ -0,0 +1,241 @@
+#include "distributions.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const struct
+{
+    const char *name;
+    distribution_kind kind;
+    int param_count;
+} distribution_names[] = {
+    {"uniform", DIST_UNIFORM, 2},
+    {"exp", DIST_EXPONENTIAL, 1},
+    {"poisson", DIST_POISSON, 1},
+    {"mmpp", DIST_MMPP, 4},
+    {"pareto", DIST_PARETO, 2},
+    {"bimodal", DIST_BIMODAL, 3},
+    {"zipf", DIST_ZIPF, 2},
+    {"lognormal", DIST_LOGNORMAL, 2},
+};
+#define DISTRIBUTION_COUNT (sizeof(distribution_names) / sizeof(distribution_names[0]))
+
+static uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+void rng_seed(rng_t *rng, uint64_t seed)
+{
+    // splitmix64 spreads any seed, 0 included, over the whole state
+    for (int i = 0; i < 4; i++)
+    {
+        uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        rng->state[i] = z ^ (z >> 31);
+    }
+}
+
+uint64_t rng_next(rng_t *rng)
+{
+    uint64_t *s = rng->state;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+void rng_jump(rng_t *rng)
+{
+    static const uint64_t jump[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL,
+                                    0x39abdc4529b1661cULL};
+    uint64_t s[4] = {0, 0, 0, 0};
+
+    for (int i = 0; i < 4; i++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (jump[i] & (1ULL << b))
+                for (int j = 0; j < 4; j++)
+                    s[j] ^= rng->state[j];
+            rng_next(rng);
+        }
+    }
+    memcpy(rng->state, s, sizeof(s));
+}
+
+double rng_uniform(rng_t *rng)
+{
+    return (rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+static double exponential(rng_t *rng, double mean)
+{
+    return -mean * log1p(-rng_uniform(rng));
+}
+
+static double normal(rng_t *rng)
+{
+    // Box-Muller, 1 - u keeps the log away from 0
+    double u = 1 - rng_uniform(rng), v = rng_uniform(rng);
+    return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+static bool valid_params(const distribution_t *dist)
+{
+    const double *p = dist->params;
+    switch (dist->kind)
+    {
+    case DIST_UNIFORM:
+        return p[0] <= p[1];
+    case DIST_EXPONENTIAL:
+        return p[0] > 0;
+    case DIST_POISSON:
+        return p[0] > 0;
+    case DIST_MMPP:
+        return p[0] > 0 && p[1] > 0 && p[2] > 0 && p[3] > 0;
+    case DIST_PARETO:
+        return p[0] > 0 && p[1] > 0;
+    case DIST_BIMODAL:
+        return p[0] > 0 && p[1] > 0 && p[2] >= 0 && p[2] <= 1;
+    case DIST_ZIPF:
+        return p[0] >= 0 && p[1] >= 1 && p[1] <= 1e7;
+    case DIST_LOGNORMAL:
+        return p[1] >= 0;
+    }
+    return false;
+}
+
+int parse_distribution(distribution_t *dist, const char *spec)
+{
+    const char *colon = strchr(spec, ':');
+    size_t name_length = colon ? (size_t)(colon - spec) : strlen(spec);
+    int param_count = -1;
+
+    memset(dist, 0, sizeof(*dist));
+    for (size_t i = 0; i < DISTRIBUTION_COUNT; i++)
+    {
+        if (strlen(distribution_names[i].name) == name_length && strncmp(spec, distribution_names[i].name, name_length) == 0)
+        {
+            dist->kind = distribution_names[i].kind;
+            param_count = distribution_names[i].param_count;
+        }
+    }
+    if (param_count == -1 || colon == NULL)
+        return -1;
+
+    const char *cursor = colon + 1;
+    for (int i = 0; i < param_count; i++)
+    {
+        char *end;
+        dist->params[i] = strtod(cursor, &end);
+        if (end == cursor || *end != (i == param_count - 1 ? '\0' : ','))
+            return -1;
+        cursor = end + 1;
+    }
+    if (!valid_params(dist))
+        return -1;
+
+    if (dist->kind == DIST_ZIPF)
+    {
+        int n = dist->params[1];
+        dist->cdf = malloc(sizeof(double) * n);
+        if (dist->cdf == NULL)
+            return -1;
+        double total = 0;
+        for (int k = 0; k < n; k++)
+            dist->cdf[k] = total += pow(k + 1, -dist->params[0]);
+        for (int k = 0; k < n; k++)
+            dist->cdf[k] /= total;
+    }
+    if (dist->kind == DIST_MMPP)
+        dist->state_left = dist->params[2];
+    return 0;
+}
+
+/*
+ * Time units until the next arrival of an mmpp, the state flips whenever
+ * its time runs out before the next arrival.
+ */
+static double mmpp_gap(distribution_t *dist, rng_t *rng)
+{
+    double gap = 0;
+    while (1)
+    {
+        double next = exponential(rng, 1 / dist->params[dist->bursting ? 1 : 0]);
+        if (next < dist->state_left)
+        {
+            dist->state_left -= next;
+            return gap + next;
+        }
+        // the arrival process is memoryless, the draw can start over in the new state
+        gap += dist->state_left;
+        dist->bursting = !dist->bursting;
+        dist->state_left = exponential(rng, dist->params[dist->bursting ? 3 : 2]);
+    }
+}
+
+double sample_distribution(distribution_t *dist, rng_t *rng)
+{
+    const double *p = dist->params;
+    switch (dist->kind)
+    {
+    case DIST_UNIFORM:
+        return p[0] + (int64_t)(rng_uniform(rng) * ((int64_t)p[1] - (int64_t)p[0] + 1));
+    case DIST_EXPONENTIAL:
+        return exponential(rng, p[0]);
+    case DIST_POISSON:
+        return exponential(rng, 1 / p[0]);
+    case DIST_MMPP:
+        return mmpp_gap(dist, rng);
+    case DIST_PARETO:
+        return p[1] / pow(1 - rng_uniform(rng), 1 / p[0]);
+    case DIST_BIMODAL:
+        return exponential(rng, rng_uniform(rng) < p[2] ? p[1] : p[0]);
+    case DIST_ZIPF:
+    {
+        // first rank whose cumulative weight reaches u
+        double u = rng_uniform(rng);
+        int low = 0, high = (int)p[1] - 1;
+        while (low < high)
+        {
+            int mid = (low + high) / 2;
+            if (dist->cdf[mid] < u)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        return low;
+    }
+    case DIST_LOGNORMAL:
+        return exp(p[0] + p[1] * normal(rng));
+    }
+    return 0;
+}
+
+void describe_distribution(const distribution_t *dist, char *buffer, int size)
+{
+    for (size_t i = 0; i < DISTRIBUTION_COUNT; i++)
+    {
+        if (distribution_names[i].kind != dist->kind)
+            continue;
+        int written = snprintf(buffer, size, "%s:", distribution_names[i].name);
+        for (int j = 0; j < distribution_names[i].param_count && written < size; j++)
+            written += snprintf(buffer + written, size - written, j ? ",%g" : "%g", dist->params[j]);
+        return;
+    }
+}
+
+void free_distribution(distribution_t *dist)
+{
+    free(dist->cdf);
+    dist->cdf = NULL;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * struct rng_s - State of a xoshiro256** generator
+ * @state: the 256 bits of state, never all zero
+ *
+ * Description: The same seed gives the same sequence on every platform,
+ *              unlike rand().
+ */
+typedef struct rng_s
+{
+    uint64_t state[4];
+} rng_t;
+
+/**
+ * distribution_kind - Distributions a workload parameter can be drawn from
+ * @DIST_UNIFORM: integers in [min, max], "uniform:min,max"
+ * @DIST_EXPONENTIAL: "exp:mean"
+ * @DIST_POISSON: gaps between arrivals of a Poisson process, "poisson:rate" in arrivals per time unit
+ * @DIST_MMPP: gaps between arrivals of a two-state Markov-modulated Poisson process,
+ *             "mmpp:quiet_rate,burst_rate,quiet_length,burst_length", the lengths being
+ *             the mean time units spent in each state
+ * @DIST_PARETO: "pareto:alpha,min", heavy-tailed for a small alpha
+ * @DIST_BIMODAL: a mix of two exponentials, "bimodal:short_mean,long_mean,long_probability"
+ * @DIST_ZIPF: ranks 0 to n - 1 where rank k has a weight of 1 / (k + 1)^s, "zipf:s,n"
+ * @DIST_LOGNORMAL: exp of a normal of mean mu and deviation sigma, "lognormal:mu,sigma"
+ */
+typedef enum
+{
+    DIST_UNIFORM = 0,
+    DIST_EXPONENTIAL,
+    DIST_POISSON,
+    DIST_MMPP,
+    DIST_PARETO,
+    DIST_BIMODAL,
+    DIST_ZIPF,
+    DIST_LOGNORMAL
+} distribution_kind;
+
+/**
+ * struct distribution_s - A distribution and its parameters
+ * @kind: the distribution
+ * @params: the parameters in the order of its spec
+ * @cdf: cumulative weights of the ranks of a zipf distribution, NULL otherwise
+ * @bursting: current state of an mmpp distribution
+ * @state_left: time units left in that state
+ */
+typedef struct distribution_s
+{
+    distribution_kind kind;
+    double params[4];
+    double *cdf;
+    bool bursting;
+    double state_left;
+} distribution_t;
+
+/**
+ * rng_seed - seeds a generator, any seed is fine.
+ * @param rng: the generator.
+ * @param seed: the seed, expanded with splitmix64.
+ */
+void rng_seed(rng_t *rng, uint64_t seed);
+
+/**
+ * rng_next - draws 64 random bits.
+ * @param rng: the generator.
+ * @return the bits.
+ */
+uint64_t rng_next(rng_t *rng);
+
+/**
+ * rng_jump - moves a generator 2^128 draws ahead.
+ * @param rng: the generator.
+ *
+ * Description: Jumping k times gives the k-th of independent streams that do
+ *              not overlap, whatever the number of draws taken from each.
+ */
+void rng_jump(rng_t *rng);
+
+/**
+ * rng_uniform - draws a double uniformly from [0, 1).
+ * @param rng: the generator.
+ * @return the double.
+ */
+double rng_uniform(rng_t *rng);
+
+/**
+ * parse_distribution - reads a distribution from its spec, "name:param,param...".
+ * @param dist: the distribution to fill, release it with free_distribution().
+ * @param spec: the spec, see distribution_kind.
+ * @return 0 on success, -1 if the spec is unknown or its parameters are out of range.
+ */
+int parse_distribution(distribution_t *dist, const char *spec);
+
+/**
+ * sample_distribution - draws a value.
+ * @param dist: the distribution, an mmpp one moves forward in time.
+ * @param rng: the generator to draw from.
+ * @return the value, an integer for uniform and zipf.
+ */
+double sample_distribution(distribution_t *dist, rng_t *rng);
+
+/**
+ * describe_distribution - writes the spec of a distribution back.
+ * @param dist: the distribution.
+ * @param buffer: where to write the spec.
+ * @param size: size of @buffer.
+ */
+void describe_distribution(const distribution_t *dist, char *buffer, int size);
+
+/**
+ * free_distribution - releases the tables of a distribution.
+ * @param dist: the distribution.
+ */
+void free_distribution(distribution_t *dist);
@@ -469,6 +469,42 @@ void fib_heap_copy(fib_heap_t *heap, fib_heap_t *dist, int (*keyExtractor)(void
   } while (root != heap->min);
 }
 
+/**
+ * fib_heap_for_each_tree - function to recursively visit a tree of nodes in a Fibonacci heap
+ * @param node: the root of the tree to visit
+ * @param visit: function called with each element and arg
+ * @param arg: passed to visit as is
+ */
+static void fib_heap_for_each_tree(heap_node_t *node, void (*visit)(void *, void *), void *arg)
+{
+  heap_node_t *current;
+
+  if (!node)
+    return;
+  current = node;
+
+  do
+  {
+    visit(current->element, arg);
+    fib_heap_for_each_tree(current->child, visit, arg);
+    current = current->right;
+  } while (current != node);
+}
+
+/**
+ * fib_heap_for_each - function to visit every element of a Fibonacci heap, in no particular order
+ * @param heap: the Fibonacci heap
+ * @param visit: function called with each element and arg
+ * @param arg: passed to visit as is
+ */
+void fib_heap_for_each(fib_heap_t *heap, void (*visit)(void *, void *), void *arg)
+{
+  if (!heap)
+    return;
+
+  fib_heap_for_each_tree(heap->min, visit, arg);
+}
+
 /**
  * fib_heap_node_free - function to recursively free memory allocated for a heap node and its children
  * @param node: the root of the subtree to free
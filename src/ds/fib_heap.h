@@ -100,6 +100,14 @@ short fib_heap_is_healthy(fib_heap_t *heap);
  */
 void fib_heap_copy(fib_heap_t *heap, fib_heap_t *dist, int (*keyExtractor)(void *));
 
+/**
+ * fib_heap_for_each - function to visit every element of a Fibonacci heap, in no particular order
+ * @param heap: the Fibonacci heap
+ * @param visit: function called with each element and arg
+ * @param arg: passed to visit as is
+ */
+void fib_heap_for_each(fib_heap_t *heap, void (*visit)(void *, void *), void *arg);
+
 /**
  * fib_heap_free - function to free memory allocated for a Fibonacci heap
  * @param heap: the Fibonacci heap to free
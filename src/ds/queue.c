@@ -115,6 +115,18 @@ void queue_copy(queue_t *my_queue, queue_t *dist)
 	}
 }
 
+/**
+ * queue_for_each - visit the elements of my_queue from front to back
+ * @param my_queue: the queue to be visited.
+ * @param visit: function called with each element and arg.
+ * @param arg: passed to visit as is.
+*/
+void queue_for_each(queue_t *my_queue, void (*visit)(void *, void *), void *arg)
+{
+	for (queue_node_t *temp = my_queue->head; temp; temp = temp->next)
+		visit(temp->data, arg);
+}
+
 /**
  * queue_free - Frees all memory allocated for the queue elements
  * @param my_queue: A pointer to the queue
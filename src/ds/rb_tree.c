@@ -0,0 +1,385 @@
+#include "rb_tree.h"
+
+/**
+ * rb_rotate_left - function to rotate a node down to the left, its right child taking its place
+ * @param tree: the tree
+ * @param node: the node
+ */
+static void rb_rotate_left(rb_tree_t *tree, rb_node_t *node)
+{
+  rb_node_t *right = node->right;
+
+  node->right = right->left;
+  if (right->left)
+    right->left->parent = node;
+  right->parent = node->parent;
+  if (!node->parent)
+    tree->root = right;
+  else if (node == node->parent->left)
+    node->parent->left = right;
+  else
+    node->parent->right = right;
+  right->left = node;
+  node->parent = right;
+}
+
+/**
+ * rb_rotate_right - function to rotate a node down to the right, its left child taking its place
+ * @param tree: the tree
+ * @param node: the node
+ */
+static void rb_rotate_right(rb_tree_t *tree, rb_node_t *node)
+{
+  rb_node_t *left = node->left;
+
+  node->left = left->right;
+  if (left->right)
+    left->right->parent = node;
+  left->parent = node->parent;
+  if (!node->parent)
+    tree->root = left;
+  else if (node == node->parent->right)
+    node->parent->right = left;
+  else
+    node->parent->left = left;
+  left->right = node;
+  node->parent = left;
+}
+
+/**
+ * rb_transplant - function to put a subtree in the place of another
+ * @param tree: the tree
+ * @param old: the root of the subtree to replace
+ * @param new: the root of the replacing subtree, may be NULL
+ */
+static void rb_transplant(rb_tree_t *tree, rb_node_t *old, rb_node_t *new)
+{
+  if (!old->parent)
+    tree->root = new;
+  else if (old == old->parent->left)
+    old->parent->left = new;
+  else
+    old->parent->right = new;
+  if (new)
+    new->parent = old->parent;
+}
+
+/**
+ * rb_is_black - function to get whether a node is black, NULL leaves being black
+ * @param node: the node
+ *
+ * @return 1 if the node is black, 0 otherwise
+ */
+static short rb_is_black(rb_node_t *node)
+{
+  return !node || node->color == RB_BLACK;
+}
+
+/**
+ * rb_insert_fixup - function to restore the red-black properties after an insertion
+ * @param tree: the tree
+ * @param node: the inserted red node
+ */
+static void rb_insert_fixup(rb_tree_t *tree, rb_node_t *node)
+{
+  rb_node_t *parent, *grandparent, *uncle;
+
+  while ((parent = node->parent) && parent->color == RB_RED)
+  {
+    // a red parent is never the root
+    grandparent = parent->parent;
+    if (parent == grandparent->left)
+    {
+      uncle = grandparent->right;
+      if (!rb_is_black(uncle))
+      {
+        parent->color = uncle->color = RB_BLACK;
+        grandparent->color = RB_RED;
+        node = grandparent;
+        continue;
+      }
+      if (node == parent->right)
+      {
+        rb_rotate_left(tree, parent);
+        node = parent;
+        parent = node->parent;
+      }
+      parent->color = RB_BLACK;
+      grandparent->color = RB_RED;
+      rb_rotate_right(tree, grandparent);
+    }
+    else
+    {
+      uncle = grandparent->left;
+      if (!rb_is_black(uncle))
+      {
+        parent->color = uncle->color = RB_BLACK;
+        grandparent->color = RB_RED;
+        node = grandparent;
+        continue;
+      }
+      if (node == parent->left)
+      {
+        rb_rotate_right(tree, parent);
+        node = parent;
+        parent = node->parent;
+      }
+      parent->color = RB_BLACK;
+      grandparent->color = RB_RED;
+      rb_rotate_left(tree, grandparent);
+    }
+  }
+  tree->root->color = RB_BLACK;
+}
+
+/**
+ * rb_erase_fixup - function to restore the red-black properties after a black node was removed
+ * @param tree: the tree
+ * @param node: the node that took its place, may be NULL
+ * @param parent: the parent of that place
+ */
+static void rb_erase_fixup(rb_tree_t *tree, rb_node_t *node, rb_node_t *parent)
+{
+  rb_node_t *sibling;
+
+  // the removed node was black, so the sibling of its place is never NULL
+  while (node != tree->root && rb_is_black(node))
+  {
+    if (node == parent->left)
+    {
+      sibling = parent->right;
+      if (sibling->color == RB_RED)
+      {
+        sibling->color = RB_BLACK;
+        parent->color = RB_RED;
+        rb_rotate_left(tree, parent);
+        sibling = parent->right;
+      }
+      if (rb_is_black(sibling->left) && rb_is_black(sibling->right))
+      {
+        sibling->color = RB_RED;
+        node = parent;
+        parent = node->parent;
+        continue;
+      }
+      if (rb_is_black(sibling->right))
+      {
+        sibling->left->color = RB_BLACK;
+        sibling->color = RB_RED;
+        rb_rotate_right(tree, sibling);
+        sibling = parent->right;
+      }
+      sibling->color = parent->color;
+      parent->color = RB_BLACK;
+      sibling->right->color = RB_BLACK;
+      rb_rotate_left(tree, parent);
+    }
+    else
+    {
+      sibling = parent->left;
+      if (sibling->color == RB_RED)
+      {
+        sibling->color = RB_BLACK;
+        parent->color = RB_RED;
+        rb_rotate_right(tree, parent);
+        sibling = parent->left;
+      }
+      if (rb_is_black(sibling->left) && rb_is_black(sibling->right))
+      {
+        sibling->color = RB_RED;
+        node = parent;
+        parent = node->parent;
+        continue;
+      }
+      if (rb_is_black(sibling->left))
+      {
+        sibling->right->color = RB_BLACK;
+        sibling->color = RB_RED;
+        rb_rotate_left(tree, sibling);
+        sibling = parent->left;
+      }
+      sibling->color = parent->color;
+      parent->color = RB_BLACK;
+      sibling->left->color = RB_BLACK;
+      rb_rotate_right(tree, parent);
+    }
+    node = tree->root;
+  }
+  if (node)
+    node->color = RB_BLACK;
+}
+
+/**
+ * rb_tree_init - function to initialize an empty red-black tree
+ * @param tree: the tree
+ */
+void rb_tree_init(rb_tree_t *tree)
+{
+  tree->root = tree->leftmost = NULL;
+  tree->size = 0;
+}
+
+/**
+ * rb_tree_insert - function to insert a node into a red-black tree
+ * @param tree: the tree
+ * @param node: the node, not in any tree
+ * @param less: function returning non-zero if its first node goes before its second
+ */
+void rb_tree_insert(rb_tree_t *tree, rb_node_t *node, int (*less)(const rb_node_t *, const rb_node_t *))
+{
+  rb_node_t *parent = NULL, **link = &tree->root;
+  short leftmost = 1;
+
+  while (*link)
+  {
+    parent = *link;
+    if (less(node, parent))
+      link = &parent->left;
+    else
+    {
+      link = &parent->right;
+      leftmost = 0;
+    }
+  }
+
+  node->parent = parent;
+  node->left = node->right = NULL;
+  node->color = RB_RED;
+  *link = node;
+  if (leftmost)
+    tree->leftmost = node;
+  tree->size++;
+  rb_insert_fixup(tree, node);
+}
+
+/**
+ * rb_tree_erase - function to remove a node from a red-black tree
+ * @param tree: the tree
+ * @param node: the node, which must be in the tree
+ */
+void rb_tree_erase(rb_tree_t *tree, rb_node_t *node)
+{
+  rb_node_t *child, *parent, *successor;
+  int removed_color;
+
+  if (tree->leftmost == node)
+    tree->leftmost = rb_tree_next(node);
+
+  if (!node->left || !node->right)
+  {
+    child = node->left ? node->left : node->right;
+    parent = node->parent;
+    removed_color = node->color;
+    rb_transplant(tree, node, child);
+  }
+  else
+  {
+    // the successor, which has no left child, takes the place of the node
+    successor = node->right;
+    while (successor->left)
+      successor = successor->left;
+    removed_color = successor->color;
+    child = successor->right;
+    if (successor->parent == node)
+      parent = successor;
+    else
+    {
+      parent = successor->parent;
+      rb_transplant(tree, successor, successor->right);
+      successor->right = node->right;
+      successor->right->parent = successor;
+    }
+    rb_transplant(tree, node, successor);
+    successor->left = node->left;
+    successor->left->parent = successor;
+    successor->color = node->color;
+  }
+
+  tree->size--;
+  if (removed_color == RB_BLACK)
+    rb_erase_fixup(tree, child, parent);
+}
+
+/**
+ * rb_tree_first - function to get the smallest node of a red-black tree
+ * @param tree: the tree
+ *
+ * @return the smallest node, or NULL if the tree is empty
+ */
+rb_node_t *rb_tree_first(rb_tree_t *tree)
+{
+  return tree->leftmost;
+}
+
+/**
+ * rb_tree_next - function to get the node that follows a node in order
+ * @param node: the node
+ *
+ * @return the next node, or NULL if node is the largest
+ */
+rb_node_t *rb_tree_next(rb_node_t *node)
+{
+  if (node->right)
+  {
+    node = node->right;
+    while (node->left)
+      node = node->left;
+    return node;
+  }
+  while (node->parent && node == node->parent->right)
+    node = node->parent;
+  return node->parent;
+}
+
+/**
+ * rb_tree_is_subtree_healthy - function to check the red-black properties of a subtree
+ * @param node: the root of the subtree
+ * @param less: the function the tree is ordered by
+ * @param count: incremented by the number of nodes of the subtree
+ *
+ * @return the number of black nodes on every path down the subtree, or -1 if it is not healthy
+ */
+static int rb_tree_is_subtree_healthy(rb_node_t *node, int (*less)(const rb_node_t *, const rb_node_t *),
+                                      size_t *count)
+{
+  int left_height, right_height;
+
+  if (!node)
+    return 1;
+  (*count)++;
+  if (node->left && (node->left->parent != node || less(node, node->left)))
+    return -1;
+  if (node->right && (node->right->parent != node || less(node->right, node)))
+    return -1;
+  if (node->color == RB_RED && (!rb_is_black(node->left) || !rb_is_black(node->right)))
+    return -1;
+
+  left_height = rb_tree_is_subtree_healthy(node->left, less, count);
+  right_height = rb_tree_is_subtree_healthy(node->right, less, count);
+  if (left_height == -1 || left_height != right_height)
+    return -1;
+  return left_height + (node->color == RB_BLACK);
+}
+
+/**
+ * rb_tree_is_healthy - function to check the red-black properties of a tree
+ * @param tree: the tree
+ * @param less: the function the tree is ordered by
+ *
+ * @return 1 if the tree is healthy, 0 otherwise
+ */
+short rb_tree_is_healthy(rb_tree_t *tree, int (*less)(const rb_node_t *, const rb_node_t *))
+{
+  size_t count = 0;
+  rb_node_t *first = tree->root;
+
+  if (tree->root && (tree->root->parent || tree->root->color != RB_BLACK))
+    return 0;
+  while (first && first->left)
+    first = first->left;
+  if (first != tree->leftmost)
+    return 0;
+  if (rb_tree_is_subtree_healthy(tree->root, less, &count) == -1)
+    return 0;
+  return count == tree->size;
+}
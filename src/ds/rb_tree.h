@@ -0,0 +1,90 @@
+#pragma once
+#include <stddef.h>
+
+#define RB_RED 0
+#define RB_BLACK 1
+
+/**
+ * struct rb_node_s - Structure representing a node of an intrusive red-black tree
+ * @parent: pointer to the parent node, NULL for the root
+ * @left: pointer to the left child
+ * @right: pointer to the right child
+ * @color: RB_RED or RB_BLACK
+ *
+ * Description: The node is embedded in the element it orders, rb_entry() gets the
+ *              element back, so the tree never allocates.
+ */
+typedef struct rb_node_s {
+  struct rb_node_s *parent;
+  struct rb_node_s *left;
+  struct rb_node_s *right;
+  int color;
+} rb_node_t;
+
+/**
+ * struct rb_tree_s - Structure representing an intrusive red-black tree
+ * @root: pointer to the root node
+ * @leftmost: pointer to the smallest node, kept so rb_tree_first() is O(1)
+ * @size: the number of nodes in the tree
+ */
+typedef struct rb_tree_s {
+  rb_node_t *root;
+  rb_node_t *leftmost;
+  size_t size;
+} rb_tree_t;
+
+/**
+ * rb_entry - gets the element a node is embedded in
+ * @node: the node
+ * @type: the type of the element
+ * @member: the name of the node in the element
+ */
+#define rb_entry(node, type, member) ((type *)((char *)(node) - offsetof(type, member)))
+
+/**
+ * rb_tree_init - function to initialize an empty red-black tree
+ * @param tree: the tree
+ */
+void rb_tree_init(rb_tree_t *tree);
+
+/**
+ * rb_tree_insert - function to insert a node into a red-black tree
+ * @param tree: the tree
+ * @param node: the node, not in any tree
+ * @param less: function returning non-zero if its first node goes before its second
+ *
+ * Description: A node equal to others goes after them.
+ */
+void rb_tree_insert(rb_tree_t *tree, rb_node_t *node, int (*less)(const rb_node_t *, const rb_node_t *));
+
+/**
+ * rb_tree_erase - function to remove a node from a red-black tree
+ * @param tree: the tree
+ * @param node: the node, which must be in the tree
+ */
+void rb_tree_erase(rb_tree_t *tree, rb_node_t *node);
+
+/**
+ * rb_tree_first - function to get the smallest node of a red-black tree
+ * @param tree: the tree
+ *
+ * @return the smallest node, or NULL if the tree is empty
+ */
+rb_node_t *rb_tree_first(rb_tree_t *tree);
+
+/**
+ * rb_tree_next - function to get the node that follows a node in order
+ * @param node: the node
+ *
+ * @return the next node, or NULL if node is the largest
+ */
+rb_node_t *rb_tree_next(rb_node_t *node);
+
+/**
+ * rb_tree_is_healthy - function to check the red-black properties of a tree
+ * @param tree: the tree
+ * @param less: the function the tree is ordered by
+ *
+ * @return 1 if the tree is healthy, 0 otherwise
+ */
+short rb_tree_is_healthy(rb_tree_t *tree, int (*less)(const rb_node_t *, const rb_node_t *));
@@ -8,6 +8,7 @@
 
 #include <time.h> // Required for: clock()
 #include "../header.h"
+#include "../workload.h"
 
 #define PATH_SIZE 256
 
@@ -55,7 +56,7 @@ int height = screenHeight / 2 - 80;
 
 char quantumSize[32] = "\0"; // Buffer to store user input for quantum size
 int algoChoice = 0;          // Variable to store user choice for algorithm
-const char *algoOptions = "Non-preemptive Highest Priority First;Shortest Remaining time Next;Round Robin";
+const char *algoOptions = "Non-preemptive Highest Priority First;Shortest Remaining time Next;Round Robin;Completely Fair Scheduler";
 int quantum = 1; // Initial value
 int totalTime = 5;
 int number_of_logs = 0;
@@ -205,7 +206,7 @@ static void WelcomeScreen()
                               LoadTexture(dev_absolute_path[3])};
     const char *welcomeText = "Welcome to";
     const char *projectName = "Synergify";
-    const char *description[] = {"This is a Process Scheduler Simulation", "Enhance your understanding of the process scheduling algorithms", "Avialable algorithms: Non-preemptive Highest Priority First, Shortest Remaining time Next, Round Robin", "Task manager to track the progress of the processes", "Image Created at the end to show information about Processes", "Enjoy!"};
+    const char *description[] = {"This is a Process Scheduler Simulation", "Enhance your understanding of the process scheduling algorithms", "Avialable algorithms: Non-preemptive Highest Priority First, Shortest Remaining time Next, Round Robin, Completely Fair Scheduler", "Task manager to track the progress of the processes", "Image Created at the end to show information about Processes", "Enjoy!"};
 
     int maxFrameCount = 80;             // The number of frames over which the text will be typed
     int maxFrameCount_description = 60; // The number of frames over which the text will be typed
@@ -438,8 +439,8 @@ FILE *fp = NULL;
 static bool inputScreen()
 {
     GuiComboBox((Rectangle){screenWidth / 2 - 110, height, 250, 30}, algoOptions, &algoChoice);
-    int buttonPressed = CustomButton((Rectangle){screenWidth / 2 - 110, height + ((algoChoice == 2) ? 190 : 110), 250, 30}, "Continue");
-    if (GuiButton((Rectangle){screenWidth / 2 - 110, height + ((algoChoice == 2) ? 150 : 60), 250, 30}, "Choose File"))
+    int buttonPressed = CustomButton((Rectangle){screenWidth / 2 - 110, height + ((algoChoice >= 2) ? 190 : 110), 250, 30}, "Continue");
+    if (GuiButton((Rectangle){screenWidth / 2 - 110, height + ((algoChoice >= 2) ? 150 : 60), 250, 30}, "Choose File"))
     {
         // Open file dialog using zenity
         fp = popen("zenity --file-selection", "r");
@@ -459,15 +460,15 @@ static bool inputScreen()
     }
 
     DrawText("Choose An Algorithm", screenWidth / 2 - 210, height - 100, 45, MAGENTA);
-    if (algoChoice == 2)
+    if (algoChoice >= 2)
     {
-        // Spinner
-        DrawText("Quantum", screenWidth / 2 - 110, height + 86, 15, MAGENTA); // Change the font size and color as needed
+        // Spinner, the quantum of RR or the target latency of CFS
+        DrawText((algoChoice == 2) ? "Quantum" : "Latency", screenWidth / 2 - 110, height + 86, 15, MAGENTA); // Change the font size and color as needed
         GuiSpinner((Rectangle){screenWidth / 2 - 40, height + 80, 180, 30}, "", &quantum, 1, 10000, false);
     }
     if ((buttonPressed || once) && fp == NULL)
     {
-        DrawText("Please select a file to continue", screenWidth / 2 - 60, height + ((algoChoice == 2) ? 225 : 150), 10, WHITE); // Change the font size and color as needed
+        DrawText("Please select a file to continue", screenWidth / 2 - 60, height + ((algoChoice >= 2) ? 225 : 150), 10, WHITE); // Change the font size and color as needed
         once = true;
         return false;
     }
@@ -475,26 +476,17 @@ static bool inputScreen()
 }
 void read_input_file()
 {
-    FILE *input_file;
-    input_file = fopen(filePath, "r");
-    if (!input_file)
-    {
-        printf("\nCould not open file processes.txt!!\n");
+    workload_t workload;
+    if (load_workload(&workload, filePath) == -1)
         exit(-1);
-    }
-    int cnt = 0;
-    char buffer[256];
-    while (fgets(buffer, sizeof(buffer), input_file))
+
+    for (size_t cnt = 0; cnt < workload.count; cnt++)
     {
-        if (buffer[0] == '#')
-            continue;
-        int id, arrival, runtime, priority;
-        sscanf(buffer, "%d %d %d %d", &id, &arrival, &runtime, &priority);
-        totalTime += runtime + ((cnt == 1) ? arrival : 0);
-        cnt++;
+        process_info_t *process = &workload.processes[cnt];
+        totalTime += process->runtime + ((cnt == 1) ? process->arrival : 0);
     }
     printf("Total Time: %d \n", totalTime);
-    fclose(input_file);
+    free_workload(&workload);
 }
 
 int is_file_empty(const char *filename)
@@ -2,6 +2,7 @@
 #include "../ds/fib_heap.h"
 #include "../ds/queue.h"
 #include "../header.h"
+#include "../policy.h"
 
 #define GRAPH_SIZE 8
 #define GRAPH_PADDING 3
@@ -16,8 +17,7 @@ static queue_t *logs;
 //================================= INPUT HANDLERS ==================================//
 //============================= TASK MANAGER FUNCTIONS ==============================//
 static fib_heap_t *copyProcessesFromReadyQUeue();
-static fib_heap_t *copyProcessesWithOrder(fib_heap_t *heap);
-static fib_heap_t *copyProcessesFromQueue(queue_t *queue);
+static void copyProcess(PCB *process, void *custom_heap);
 static int selectKey(void *data);
 static void updateData();
 static void updateMonitorData(PCB *current, PCB *prev, int time);
@@ -168,40 +168,17 @@ static int selectKey(void *data)
 }
 
 static fib_heap_t *copyProcessesFromReadyQUeue() {
-    SchedulerConfig *schedulerConfig = getSchedulerConfigInstance();
-    scheduling_algo selected_algo = schedulerConfig->selected_algorithm;
-    if (selected_algo == RR)
-        return copyProcessesFromQueue((queue_t *)processes);
-    else
-        return copyProcessesWithOrder((fib_heap_t *)processes);
-
-}
-
-
-static fib_heap_t *copyProcessesWithOrder(fib_heap_t *heap) {
+    const policy_t *policy = getSchedulerConfigInstance()->policy;
     fib_heap_t *custom_heap = fib_heap_alloc();
 
     // Create custom ordered heap
-    fib_heap_copy(heap, custom_heap, &selectKey);
+    policy->iterate(processes, copyProcess, custom_heap);
 
     return custom_heap;
 }
 
-static fib_heap_t *copyProcessesFromQueue(queue_t *queue) {
-    queue_t *temp_queue = create_queue();
-    fib_heap_t *custom_heap = fib_heap_alloc();
-
-    // Create custom ordered heap
-    queue_copy(queue, temp_queue);
-
-    // Create custom ordered heap
-    while (!is_queue_empty(temp_queue))
-    {
-        void *element = dequeue(temp_queue);
-        fib_heap_insert(custom_heap, element, selectKey(element));
-    }
-    queue_free(temp_queue, 0);
-    return custom_heap;
+static void copyProcess(PCB *process, void *custom_heap) {
+    fib_heap_insert((fib_heap_t *)custom_heap, process, selectKey(process));
 }
 
 void drawPage(GUIPage *page)
@@ -313,6 +290,9 @@ static void drawProcess(PCB *element, int idx, int offsetY)
         case RUNNING:
             DrawTextEx(gui.font, "RUNNING", (Vector2){bounds.x, bounds.y + textOffsetY}, font_size, 0, TEXT_COLOR);
             break;
+        case FINISHED:
+            DrawTextEx(gui.font, "FINISHED", (Vector2){bounds.x, bounds.y + textOffsetY}, font_size, 0, TEXT_COLOR);
+            break;
         case READY:
         default:
             DrawTextEx(gui.font, "READY", (Vector2){bounds.x, bounds.y + textOffsetY}, font_size, 0, TEXT_COLOR);
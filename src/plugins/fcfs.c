@@ -0,0 +1,65 @@
+#include "../policy.h"
+#include "../ds/queue.h"
+
+// Sample policy plugin: First Come First Served, processes run to completion in
+// the order they became ready.
+// gcc -shared -fPIC -fvisibility=hidden -O2 src/plugins/fcfs.c src/ds/queue.c -o bin/fcfs.so
+// ./bin/process_generator.out ./bin/fcfs.so 0 <processes_file>
+
+static void *initFCFS(SchedulerConfig *config)
+{
+    return (void *)create_queue();
+}
+
+static void destroyFCFS(void *ready)
+{
+    queue_free((queue_t *)ready, true);
+}
+
+static void enqueueFCFS(void *ready, PCB *process)
+{
+    enqueue((queue_t *)ready, (void *)process);
+}
+
+static PCB *pickNextFCFS(void *ready)
+{
+    return (PCB *)front((queue_t *)ready);
+}
+
+static void onTickFCFS(void *ready)
+{
+}
+
+static void onPreemptFCFS(void *ready, PCB *process)
+{
+}
+
+static PCB *onFinishFCFS(void *ready)
+{
+    return (PCB *)dequeue((queue_t *)ready);
+}
+
+static void iterateFCFS(void *ready, void (*visit)(PCB *process, void *arg), void *arg)
+{
+    queue_for_each((queue_t *)ready, (void (*)(void *, void *))visit, arg);
+}
+
+static int sizeFCFS(void *ready)
+{
+    return ((queue_t *)ready)->size;
+}
+
+static const policy_t fcfs_policy = {
+    .name = "FCFS",
+    .init = initFCFS,
+    .destroy = destroyFCFS,
+    .enqueue = enqueueFCFS,
+    .pick_next = pickNextFCFS,
+    .on_tick = onTickFCFS,
+    .on_preempt = onPreemptFCFS,
+    .on_finish = onFinishFCFS,
+    .iterate = iterateFCFS,
+    .size = sizeFCFS,
+};
+
+POLICY_PLUGIN(fcfs_policy);
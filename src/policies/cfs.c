@@ -0,0 +1,245 @@
+#include "../policy.h"
+#include "../ds/rb_tree.h"
+
+#define CFS_TARGET_LATENCY 24   /* time units in which every ready process should run once, by default */
+#define CFS_MIN_GRANULARITY 3   /* fewest time units a process runs once picked, by default */
+#define CFS_NICE_0_WEIGHT 1024  /* weight of a nice 0 process, whose vruntime grows by it every time unit */
+#define CFS_NICE_0_PRIORITY 5   /* priority given the nice 0 weight, the middle of the generator's 0 to 10 */
+
+/**
+ * Completely Fair Scheduler: every process gains vruntime as it runs, slower the
+ * higher its priority, and the one that has the least runs next. A process runs for
+ * its share of the target latency, never less than the minimum granularity, before
+ * it may be preempted.
+ */
+
+// Weights of nice -20 to 19, each nice level is worth about 10% of CPU time
+static const int nice_to_weight[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+    9548, 7620, 6100, 4904, 3906,
+    3121, 2501, 1991, 1586, 1277,
+    1024, 820, 655, 526, 423,
+    335, 272, 215, 172, 137,
+    110, 87, 70, 56, 45,
+    36, 29, 23, 18, 15,
+};
+
+/**
+ * struct cfs_rq_s - Ready structure of CFS
+ * @timeline: the processes waiting to run, ordered by vruntime
+ * @curr: the process picked to run, out of the timeline, NULL if none is
+ * @slice_used: time units curr has run since it was picked
+ * @min_vruntime: never decreasing minimum vruntime of the run queue, new processes start at it
+ * @total_weight: weight of every process of the run queue, curr included
+ * @target_latency: time units in which every ready process should run once
+ * @min_granularity: fewest time units a process runs once picked
+ */
+typedef struct cfs_rq_s
+{
+    rb_tree_t timeline;
+    PCB *curr;
+    int slice_used;
+    int64_t min_vruntime;
+    long total_weight;
+    int target_latency;
+    int min_granularity;
+} cfs_rq_t;
+
+/**
+ * weightOf - Maps the priority of a process to its weight, a lower priority number weighing more
+ * @param process: The process
+ * @return The weight
+ */
+static int weightOf(PCB *process)
+{
+    int nice = process->priority - CFS_NICE_0_PRIORITY;
+    if (nice < -20)
+        nice = -20;
+    if (nice > 19)
+        nice = 19;
+    return nice_to_weight[nice + 20];
+}
+
+static int lessVruntime(const rb_node_t *a, const rb_node_t *b)
+{
+    return rb_entry(a, PCB, run_node)->vruntime < rb_entry(b, PCB, run_node)->vruntime;
+}
+
+/**
+ * updateMinVruntime - Moves min_vruntime up to the smallest vruntime of the run queue
+ * @param rq: The run queue
+ */
+static void updateMinVruntime(cfs_rq_t *rq)
+{
+    rb_node_t *first = rb_tree_first(&rq->timeline);
+    int64_t vruntime;
+
+    if (rq->curr == NULL && first == NULL)
+        return;
+    if (rq->curr == NULL)
+        vruntime = rb_entry(first, PCB, run_node)->vruntime;
+    else if (first == NULL || rq->curr->vruntime < rb_entry(first, PCB, run_node)->vruntime)
+        vruntime = rq->curr->vruntime;
+    else
+        vruntime = rb_entry(first, PCB, run_node)->vruntime;
+    if (vruntime > rq->min_vruntime)
+        rq->min_vruntime = vruntime;
+}
+
+/**
+ * timeSlice - Time units a process runs for before it may be preempted
+ * @param rq: The run queue
+ * @param process: The process
+ * @return Its share of the target latency by weight, at least the minimum granularity
+ */
+static int timeSlice(cfs_rq_t *rq, PCB *process)
+{
+    int slice = (int)((int64_t)rq->target_latency * weightOf(process) / rq->total_weight);
+    return slice > rq->min_granularity ? slice : rq->min_granularity;
+}
+
+static void *initCFS(SchedulerConfig *config)
+{
+    cfs_rq_t *rq = calloc(1, sizeof(cfs_rq_t));
+    rb_tree_init(&rq->timeline);
+    rq->target_latency = config->quantum > 0 ? config->quantum : CFS_TARGET_LATENCY;
+    rq->min_granularity = config->min_granularity > 0 ? config->min_granularity : CFS_MIN_GRANULARITY;
+    return (void *)rq;
+}
+
+/**
+ * freeTimeline - Frees the processes of a subtree of the timeline
+ * @param node: The root of the subtree
+ */
+static void freeTimeline(rb_node_t *node)
+{
+    if (node == NULL)
+        return;
+    freeTimeline(node->left);
+    freeTimeline(node->right);
+    free(rb_entry(node, PCB, run_node));
+}
+
+static void destroyCFS(void *ready)
+{
+    cfs_rq_t *rq = (cfs_rq_t *)ready;
+    freeTimeline(rq->timeline.root);
+    free(rq->curr);
+    free(rq);
+}
+
+/**
+ * enqueueCFS - Adds a new process at the minimum vruntime of the run queue
+ * @param ready: The run queue
+ * @param process: The process
+ *
+ * Description: Starting at min_vruntime instead of 0, a new process gets the CPU soon
+ *              but can't monopolize it to catch up with the ones that ran before it came.
+ */
+static void enqueueCFS(void *ready, PCB *process)
+{
+    cfs_rq_t *rq = (cfs_rq_t *)ready;
+    process->vruntime = rq->min_vruntime;
+    rb_tree_insert(&rq->timeline, &process->run_node, lessVruntime);
+    rq->total_weight += weightOf(process);
+}
+
+/**
+ * pickNextCFS - Picks the process with the least vruntime once the running one is preempted
+ * @param ready: The run queue
+ * @return The process that should be running
+ */
+static PCB *pickNextCFS(void *ready)
+{
+    cfs_rq_t *rq = (cfs_rq_t *)ready;
+    rb_node_t *first;
+
+    if (rq->curr != NULL)
+        return rq->curr;
+    first = rb_tree_first(&rq->timeline);
+    if (first == NULL)
+        return NULL;
+    rb_tree_erase(&rq->timeline, first);
+    rq->curr = rb_entry(first, PCB, run_node);
+    rq->slice_used = 0;
+    return rq->curr;
+}
+
+/**
+ * onTickCFS - Charges the running process a time unit of vruntime
+ * @param ready: The run queue
+ *
+ * Description: Once its slice is used up it goes back to the timeline if another
+ *              process has less vruntime, that one is picked next.
+ */
+static void onTickCFS(void *ready)
+{
+    cfs_rq_t *rq = (cfs_rq_t *)ready;
+    PCB *curr = rq->curr;
+
+    if (curr == NULL)
+        return;
+
+    curr->vruntime += CFS_NICE_0_WEIGHT * CFS_NICE_0_WEIGHT / weightOf(curr);
+    rq->slice_used++;
+    updateMinVruntime(rq);
+
+    rb_node_t *first = rb_tree_first(&rq->timeline);
+    if (first != NULL && rq->slice_used >= timeSlice(rq, curr) &&
+        rb_entry(first, PCB, run_node)->vruntime < curr->vruntime)
+    {
+        rb_tree_insert(&rq->timeline, &curr->run_node, lessVruntime);
+        rq->curr = NULL;
+    }
+}
+
+static void onPreemptCFS(void *ready, PCB *process)
+{
+    cfs_rq_t *rq = (cfs_rq_t *)ready;
+    if (process != rq->curr)
+        return;
+    rb_tree_insert(&rq->timeline, &process->run_node, lessVruntime);
+    rq->curr = NULL;
+}
+
+static PCB *onFinishCFS(void *ready)
+{
+    cfs_rq_t *rq = (cfs_rq_t *)ready;
+    PCB *process = pickNextCFS(ready);
+
+    if (process == NULL)
+        return NULL;
+    rq->curr = NULL;
+    rq->total_weight -= weightOf(process);
+    updateMinVruntime(rq);
+    return process;
+}
+
+static void iterateCFS(void *ready, void (*visit)(PCB *process, void *arg), void *arg)
+{
+    cfs_rq_t *rq = (cfs_rq_t *)ready;
+    if (rq->curr != NULL)
+        visit(rq->curr, arg);
+    for (rb_node_t *node = rb_tree_first(&rq->timeline); node != NULL; node = rb_tree_next(node))
+        visit(rb_entry(node, PCB, run_node), arg);
+}
+
+static int sizeCFS(void *ready)
+{
+    cfs_rq_t *rq = (cfs_rq_t *)ready;
+    return rq->timeline.size + (rq->curr != NULL);
+}
+
+const policy_t cfs_policy = {
+    .name = "CFS",
+    .init = initCFS,
+    .destroy = destroyCFS,
+    .enqueue = enqueueCFS,
+    .pick_next = pickNextCFS,
+    .on_tick = onTickCFS,
+    .on_preempt = onPreemptCFS,
+    .on_finish = onFinishCFS,
+    .iterate = iterateCFS,
+    .size = sizeCFS,
+};
@@ -0,0 +1,73 @@
+#include "../policy.h"
+#include "../ds/fib_heap.h"
+
+/**
+ * Highest Priority First, non-preemptive: a Fibonacci heap keyed by priority, the
+ * running process has its key dropped to 0 so a new arrival never replaces it.
+ */
+
+static void *initHPF(SchedulerConfig *config)
+{
+    return (void *)fib_heap_alloc();
+}
+
+static void destroyHPF(void *ready)
+{
+    fib_heap_free((fib_heap_t *)ready, 1);
+}
+
+static void enqueueHPF(void *ready, PCB *process)
+{
+    fib_heap_insert((fib_heap_t *)ready, (void *)process, process->priority);
+}
+
+static PCB *pickNextHPF(void *ready)
+{
+    return (PCB *)fib_heap_min((fib_heap_t *)ready);
+}
+
+/**
+ * onTickHPF - Decreases the key of the running process to make sure it is never replaced
+ * @param ready: The heap
+ */
+static void onTickHPF(void *ready)
+{
+    fib_heap_t *heap = (fib_heap_t *)ready;
+
+    if (fib_heap_min(heap) == NULL)
+        return;
+
+    fib_heap_decrease_min_key(heap, 0);
+}
+
+static void onPreemptHPF(void *ready, PCB *process)
+{
+}
+
+static PCB *onFinishHPF(void *ready)
+{
+    return (PCB *)fib_heap_extract_min((fib_heap_t *)ready);
+}
+
+static void iterateHPF(void *ready, void (*visit)(PCB *process, void *arg), void *arg)
+{
+    fib_heap_for_each((fib_heap_t *)ready, (void (*)(void *, void *))visit, arg);
+}
+
+static int sizeHPF(void *ready)
+{
+    return fib_heap_size((fib_heap_t *)ready);
+}
+
+const policy_t hpf_policy = {
+    .name = "HPF",
+    .init = initHPF,
+    .destroy = destroyHPF,
+    .enqueue = enqueueHPF,
+    .pick_next = pickNextHPF,
+    .on_tick = onTickHPF,
+    .on_preempt = onPreemptHPF,
+    .on_finish = onFinishHPF,
+    .iterate = iterateHPF,
+    .size = sizeHPF,
+};
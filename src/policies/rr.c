@@ -0,0 +1,102 @@
+#include "../policy.h"
+#include "../ds/queue.h"
+
+/**
+ * struct rr_queue_s - Ready structure of Round Robin
+ * @queue: the ready processes, the running one at the front
+ * @config: the scheduler configuration holding the quantum and what is left of it
+ */
+typedef struct rr_queue_s
+{
+    queue_t *queue;
+    SchedulerConfig *config;
+} rr_queue_t;
+
+static void *initRR(SchedulerConfig *config)
+{
+    rr_queue_t *rr = malloc(sizeof(rr_queue_t));
+    rr->queue = create_queue();
+    rr->config = config;
+    config->curr_quantum = config->quantum;
+    return (void *)rr;
+}
+
+static void destroyRR(void *ready)
+{
+    rr_queue_t *rr = (rr_queue_t *)ready;
+    queue_free(rr->queue, true);
+    free(rr);
+}
+
+static void enqueueRR(void *ready, PCB *process)
+{
+    enqueue(((rr_queue_t *)ready)->queue, (void *)process);
+}
+
+static PCB *pickNextRR(void *ready)
+{
+    return (PCB *)front(((rr_queue_t *)ready)->queue);
+}
+
+/**
+ * onTickRR - Takes a time unit off the quantum of the running process
+ * @param ready: The Round Robin queue
+ *
+ * Description: Once the quantum runs out the process is pushed to the back of the
+ *              queue and the next one gets a whole quantum.
+ */
+static void onTickRR(void *ready)
+{
+    rr_queue_t *rr = (rr_queue_t *)ready;
+    PCB *running_process = (PCB *)front(rr->queue);
+
+    // Return if there is no running process
+    if (running_process == NULL)
+        return;
+
+    rr->config->curr_quantum--;
+    if (rr->config->curr_quantum == 0)
+    {
+        // 1. Push Process To The Back Of The Queue.
+        enqueue(rr->queue, running_process);
+        dequeue(rr->queue);
+        // 2. Reset Quantum.
+        rr->config->curr_quantum = rr->config->quantum;
+    }
+}
+
+static void onPreemptRR(void *ready, PCB *process)
+{
+    rr_queue_t *rr = (rr_queue_t *)ready;
+    rr->config->curr_quantum = rr->config->quantum;
+}
+
+static PCB *onFinishRR(void *ready)
+{
+    rr_queue_t *rr = (rr_queue_t *)ready;
+    rr->config->curr_quantum = rr->config->quantum;
+    return (PCB *)dequeue(rr->queue);
+}
+
+static void iterateRR(void *ready, void (*visit)(PCB *process, void *arg), void *arg)
+{
+    queue_for_each(((rr_queue_t *)ready)->queue, (void (*)(void *, void *))visit, arg);
+}
+
+static int sizeRR(void *ready)
+{
+    return ((rr_queue_t *)ready)->queue->size;
+}
+
+const policy_t rr_policy = {
+    .name = "RR",
+    .init = initRR,
+    .destroy = destroyRR,
+    .enqueue = enqueueRR,
+    .pick_next = pickNextRR,
+    .on_tick = onTickRR,
+    .on_preempt = onPreemptRR,
+    .on_finish = onFinishRR,
+    .iterate = iterateRR,
+    .size = sizeRR,
+};
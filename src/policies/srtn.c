@@ -0,0 +1,74 @@
+#include "../policy.h"
+#include "../ds/fib_heap.h"
+
+/**
+ * Shortest Remaining Time Next: a Fibonacci heap keyed by the time each process has
+ * left, the running process has its key decremented every time unit it runs.
+ */
+
+static void *initSRTN(SchedulerConfig *config)
+{
+    return (void *)fib_heap_alloc();
+}
+
+static void destroySRTN(void *ready)
+{
+    fib_heap_free((fib_heap_t *)ready, 1);
+}
+
+static void enqueueSRTN(void *ready, PCB *process)
+{
+    fib_heap_insert((fib_heap_t *)ready, (void *)process, process->runtime);
+}
+
+static PCB *pickNextSRTN(void *ready)
+{
+    return (PCB *)fib_heap_min((fib_heap_t *)ready);
+}
+
+/**
+ * onTickSRTN - Decrements the key of the running process, as it is its remaining time
+ * @param ready: The heap
+ */
+static void onTickSRTN(void *ready)
+{
+    heap_node_t *min = ((fib_heap_t *)ready)->min;
+
+    if (min == NULL)
+        return;
+
+    if (min->key > 0)
+        min->key--;
+}
+
+static void onPreemptSRTN(void *ready, PCB *process)
+{
+}
+
+static PCB *onFinishSRTN(void *ready)
+{
+    return (PCB *)fib_heap_extract_min((fib_heap_t *)ready);
+}
+
+static void iterateSRTN(void *ready, void (*visit)(PCB *process, void *arg), void *arg)
+{
+    fib_heap_for_each((fib_heap_t *)ready, (void (*)(void *, void *))visit, arg);
+}
+
+static int sizeSRTN(void *ready)
+{
+    return fib_heap_size((fib_heap_t *)ready);
+}
+
+const policy_t srtn_policy = {
+    .name = "SRTN",
+    .init = initSRTN,
+    .destroy = destroySRTN,
+    .enqueue = enqueueSRTN,
+    .pick_next = pickNextSRTN,
+    .on_tick = onTickSRTN,
+    .on_preempt = onPreemptSRTN,
+    .on_finish = onFinishSRTN,
+    .iterate = iterateSRTN,
+    .size = sizeSRTN,
+};
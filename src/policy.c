@@ -0,0 +1,52 @@
+#include "policy.h"
+#include <dlfcn.h>
+
+// A new algorithm adds its file to src/policies/ and its policy here
+static const policy_t *const policies[] = {
+    [HPF] = &hpf_policy,
+    [SRTN] = &srtn_policy,
+    [RR] = &rr_policy,
+    [CFS] = &cfs_policy,
+};
+
+const policy_t *getPolicy(scheduling_algo algorithm)
+{
+    if (algorithm < 0 || algorithm >= sizeof(policies) / sizeof(policies[0]))
+        return NULL;
+    return policies[algorithm];
+}
+
+const policy_t *loadPolicy(const char *path)
+{
+    void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (handle == NULL)
+    {
+        printf("Couldn't load the policy plugin: %s\n", dlerror());
+        return NULL;
+    }
+
+    const policy_plugin_t *plugin = (const policy_plugin_t *)dlsym(handle, POLICY_PLUGIN_SYMBOL);
+    if (plugin == NULL)
+    {
+        printf("%s is not a policy plugin, it has no %s\n", path, POLICY_PLUGIN_SYMBOL);
+        dlclose(handle);
+        return NULL;
+    }
+    if (plugin->abi_version != POLICY_ABI_VERSION || plugin->pcb_size != sizeof(PCB))
+    {
+        printf("%s was built for policy ABI %u with a %u-byte PCB, the scheduler has ABI %d with a %zu-byte PCB\n",
+               path, plugin->abi_version, plugin->pcb_size, POLICY_ABI_VERSION, sizeof(PCB));
+        dlclose(handle);
+        return NULL;
+    }
+
+    const policy_t *policy = plugin->policy;
+    if (policy == NULL || !policy->init || !policy->destroy || !policy->enqueue || !policy->pick_next ||
+        !policy->on_tick || !policy->on_preempt || !policy->on_finish || !policy->iterate || !policy->size)
+    {
+        printf("%s leaves callbacks of its policy out\n", path);
+        dlclose(handle);
+        return NULL;
+    }
+    return policy;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "header.h"
+
+#define POLICY_ABI_VERSION 2                 /* bumped whenever policy_t, PCB or SchedulerConfig change */
+#define POLICY_PLUGIN_SYMBOL "policy_plugin" /* what a plugin exports its policy_plugin_t as */
+
+/**
+ * struct policy_s - A scheduling algorithm, the scheduler only runs it through these
+ * @name: name of the algorithm
+ * @init: allocates the ready structure of the algorithm, its first argument for the others
+ * @destroy: frees the ready structure and the processes left in it
+ * @enqueue: adds a process that is ready to run
+ * @pick_next: returns the process that should be running, left in the ready structure,
+ *             or NULL if there is none
+ * @on_tick: the running process ran one more time unit and has time left
+ * @on_preempt: the running process stops running while it stays in the ready structure
+ * @on_finish: removes the process pick_next() returns, once it has finished, and returns it
+ * @iterate: calls visit with every process of the ready structure, in no particular order
+ * @size: number of processes in the ready structure, the running one included
+ *
+ * Description: Each algorithm lives in a file of src/policies/ that fills one of these
+ *              in, and getPolicy() maps the number the scheduler is started with to it.
+ *              The running process stays in the ready structure until it finishes.
+ */
+typedef struct policy_s
+{
+    const char *name;
+    void *(*init)(SchedulerConfig *config);
+    void (*destroy)(void *ready);
+    void (*enqueue)(void *ready, PCB *process);
+    PCB *(*pick_next)(void *ready);
+    void (*on_tick)(void *ready);
+    void (*on_preempt)(void *ready, PCB *process);
+    PCB *(*on_finish)(void *ready);
+    void (*iterate)(void *ready, void (*visit)(PCB *process, void *arg), void *arg);
+    int (*size)(void *ready);
+} policy_t;
+
+/**
+ * struct policy_plugin_s - What a policy plugin exports as POLICY_PLUGIN_SYMBOL
+ * @abi_version: POLICY_ABI_VERSION the plugin was built with
+ * @pcb_size: sizeof(PCB) the plugin was built with
+ * @policy: the policy the plugin runs
+ *
+ * Description: A plugin is a shared object whose source includes this header and
+ *              ends with POLICY_PLUGIN(its policy). Its callbacks get the scheduler's
+ *              own PCBs, so it is only loaded if it was built against the same
+ *              layout of them.
+ */
+typedef struct policy_plugin_s
+{
+    uint32_t abi_version;
+    uint32_t pcb_size;
+    const policy_t *policy;
+} policy_plugin_t;
+
+#define POLICY_PLUGIN(p) __attribute__((visibility("default"))) const policy_plugin_t policy_plugin = {POLICY_ABI_VERSION, sizeof(PCB), &(p)}
+
+extern const policy_t hpf_policy;
+extern const policy_t srtn_policy;
+extern const policy_t rr_policy;
+extern const policy_t cfs_policy;
+
+/**
+ * getPolicy - Maps a scheduling algorithm to its policy
+ * @param algorithm: The number of the algorithm
+ * @return The policy, or NULL if there is no such algorithm
+ */
+const policy_t *getPolicy(scheduling_algo algorithm);
+
+/**
+ * loadPolicy - Loads the policy of a plugin
+ * @param path: Path of the shared object, as given to dlopen()
+ * @return The policy, or NULL if the plugin can't be loaded or was built for another ABI
+ *
+ * Description: The plugin stays loaded until the process exits.
+ */
+const policy_t *loadPolicy(const char *path);
@@ -1,16 +1,24 @@
 #include "clk.h"
 #include "header.h"
+#include "process_table.h"
 
 ///==============================
 // global variables
 int remaining_time;
-int prev_time;
+volatile int prev_time;
+volatile sig_atomic_t dispatched = false;
+process_slot_t *slot;    // the slot of the process table this process reports through
+int slot_id;             // index of that slot, sent with the completion
+bool worker = false;     // a pooled worker, its jobs are handed through the slot
+uint32_t job_seq = 0;    // last job picked up from the slot
 ///==============================
 
 ///==============================
 // functions
 void allocateCPU(int);
 void pauseProcess(int);
+void waitForDispatch();
+void runJob();
 ///==============================
 
 int main(int argc, char *argv[])
@@ -21,53 +29,143 @@ int main(int argc, char *argv[])
     signal(SIGUSR1, pauseProcess);
     ///==============================
 
-    // Sleep till the scheduler wakes me up
-    pause();
+    // hold back a dispatch until the clock is attached, waitForDispatch() releases it
+    sigset_t cont_mask;
+    sigemptyset(&cont_mask);
+    sigaddset(&cont_mask, SIGCONT);
+    sigprocmask(SIG_BLOCK, &cont_mask, NULL);
 
-    if (argc != 5)
+    // A pooled worker runs one job after the other, they are handed through its slot
+    worker = argc == 3 && strcmp(argv[1], "worker") == 0;
+    if (!worker && argc != 6)
     {
-        perror("Use: ./process <id> <arrival_time> <running_time> <priority>");
+        perror("Use: ./process <id> <arrival_time> <running_time> <priority> <slot> | ./process worker <slot>");
         exit(EXIT_FAILURE);
     }
+    process_table_t *table = process_table_attach(PROCESS_TABLE_SHKEY);
+    if (table == NULL)
+    {
+        perror("Error in attaching the process table");
+        exit(EXIT_FAILURE);
+    }
+    slot_id = atoi(argv[argc - 1]);
+    slot = &table->slots[slot_id];
 
-    // initialize the clk and set the previous time step
+    // initialize the clk, the previous time step is set on dispatch
     initClk();
-    prev_time = getClk();
+    readyClkProcess();
 
     // TODO it needs to get the remaining time from somewhere
-    remaining_time = atoi(argv[3]);
+    if (!worker)
+        remaining_time = atoi(argv[3]);
+
+    do
+    {
+        // Sleep till the scheduler wakes me up, a worker gets its job with the dispatch
+        waitForDispatch();
+        runJob();
+    } while (worker);
+
+    destroyClk(false);
+    return 0;
+}
+
+/**
+ * runJob - Runs the job until its remaining time is used up and reports its finish
+ *
+ * Description: The job is stopped and continued by the signal handlers meanwhile.
+ */
+void runJob()
+{
+    int runtime = remaining_time;
 
     while (remaining_time > 0)
     {
-        if (getClk() == prev_time)
+        // a stop/continue pair may arrive at any point of the iteration, the
+        // continue handler moves prev_time forward so a stale reading just waits
+        int64_t ticks = getClkTicks();
+        int now = ticks / CLK_TICKS_PER_UNIT;
+        if (now <= prev_time)
+        {
+            waitForTick(ticks);
             continue;
-        if (getClk() - prev_time > 1)
+        }
+        if (now - prev_time > 1)
         {
-            prev_time = getClk();
+            prev_time = now;
             continue;
         }
         remaining_time -= 1;
-        prev_time = getClk();
-        
-        if (remaining_time > 0){
-            kill(getppid(), SIGPWR);            //sends a signal to scheduler to make it decrement its runtime.
+        prev_time = now;
+
+        // the scheduler reads the slot on its tick, the report only wakes it up
+        slot->last_run = ticks;
+        slot->remaining_time = remaining_time;
+        if (remaining_time > 0)
+        {
+            reportClkProcess();
+            ringClk();
         }
     }
 
-    // Send a signal to the scheduler to inform it that this process did finish
-    destroyClk(false);
-    kill(getppid(), SIGALRM);
-    return 0;
+    // a worker may be handed its next job as soon as the scheduler knows it is done
+    dispatched = false;
+
+    // Queue the completion to the scheduler, a full signal queue is retried rather than lost
+    union sigval completion = {.sival_int = slot_id};
+    reportClkProcess();
+    while (sigqueue(getppid(), COMPLETION_SIGNAL, completion) == -1 && errno == EAGAIN)
+        sched_yield();
+    ringClk();
+    // a process with no running time reports before acknowledging its dispatch
+    if (runtime == 0)
+        ackClkProcess();
 }
 
 void allocateCPU(int sig_num)
 {
-    // allocate the CPU
-    prev_time -= 1;
+    // the first dispatch of a job hands it to a pooled worker
+    if (worker && slot->job_seq != job_seq)
+    {
+        job_seq = slot->job_seq;
+        remaining_time = slot->runtime;
+    }
+
+    // allocate the CPU and resync with the clock, the acknowledgement of a
+    // process with no running time waits for its finish report
+    prev_time = getClk();
+    dispatched = true;
+    slot->state = RUNNING;
+    if (remaining_time > 0)
+        ackClkProcess();
     return;
 }
 
 void pauseProcess(int sig_num)
 {
-    pause();
+    dispatched = false;
+    slot->state = READY;
+    ackClkProcess();
+    waitForDispatch();
+}
+
+/**
+ * waitForDispatch - Sleeps until the scheduler sends SIGCONT
+ *
+ * Description: SIGCONT is blocked while checking the flag so a continue that
+ *              arrives right before sleeping is not lost.
+ */
+void waitForDispatch()
+{
+    sigset_t block_mask, old_mask;
+
+    sigemptyset(&block_mask);
+    sigaddset(&block_mask, SIGCONT);
+    sigprocmask(SIG_BLOCK, &block_mask, &old_mask);
+
+    sigdelset(&old_mask, SIGCONT);
+    while (!dispatched)
+        sigsuspend(&old_mask);
+
+    sigprocmask(SIG_UNBLOCK, &block_mask, NULL);
 }
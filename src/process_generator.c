@@ -1,9 +1,11 @@
 #include "clk.h"
 #include "header.h"
 #include "clk.h"
-#include "./ds/queue.h"
+#include "workload_sort.h"
+#include "arrival_ring.h"
 #include <stdarg.h>
 #include <unistd.h>
+#include <sys/resource.h>
 
 ///==============================
 // constants related to process_generator
@@ -14,23 +16,39 @@ const char *clk_file_name = "clk.out\0";
 ///==============================
 // functions
 void clearResources(int);
-void read_input_file(queue_t *, char *);
+void read_input_file(workload_merge_t *, char *const[], int);
 void childLost(int);
 void get_scheduling_algo(int *algorithm_choosen, int *quantum_time);
 int start_program(const char *const file_name, int n, ...);
+void send_arrivals(msgbuf_t *msgbuf, int now_time);
+void wait_for_scheduler();
+void record_lateness(process_info_t *process, int now_time);
 ///==============================
 
 ///==============================
 /// global variables for process_generator
 int msgq_id;
 int scheduler_id;
+arrival_transport transport = ARRIVAL_MSGQ;
+arrival_ring_t *arrival_ring = NULL;
+long arrivals_sent = 0;
+long arrival_syscalls = 0;
+long backpressure_stalls = 0; // sends that found the queue or ring full
+int64_t blocked_ns = 0;       // time spent waiting for the scheduler to make room
+long late_arrivals = 0;       // processes sent after their arrival time unit
+int max_late_units = 0;       // largest number of time units a process was sent late
+int64_t delivery_delay_ns = 0;     // sum of wall time between a process's arrival tick and its delivery
+int64_t max_delivery_delay_ns = 0; // largest of those delays
+bool sort_inputs = false;          // sort the processes files that are not sorted by arrival first
+long unsorted_arrivals = 0;        // processes sent after a process arriving later than them
 ///==============================
 
-int main(int argc, char *argv[]) // algorithm, quantum, file_path
+int main(int argc, char *argv[]) // algorithm or plugin path, quantum, file_path..., [-v] [-t tick_period] [-r] [-s] [-i] [-w workers]
 {
     ///==============================
     // data
-    queue_t *processes_queue = create_queue();
+    workload_merge_t workload;
+    size_t delivered = 0;
     ///==============================
 
     ///==============================
@@ -39,17 +57,61 @@ int main(int argc, char *argv[]) // algorithm, quantum, file_path
     signal(SIGCHLD, childLost);
     ///==============================
 
+    // Optional flags may follow the positional arguments, -v runs the clock in virtual time,
+    // -t sets the wall time of a clock tick (half a time unit) and -r sends the arrivals
+    // through the shared memory ring instead of the message queue. -s sorts the processes
+    // files that are not sorted by arrival before the run. -i has the scheduler run the
+    // processes itself instead of forking a process.out for each of them, -w has them run
+    // by a pool of that many process.out workers spawned up front.
+    bool virtual_time = false, virtual_processes = false;
+    char *tick_period = "500ms", *pool_size = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "vt:rsiw:")) != -1)
+    {
+        if (opt == 'v')
+            virtual_time = true;
+        else if (opt == 't')
+            tick_period = optarg;
+        else if (opt == 'r')
+            transport = ARRIVAL_RING;
+        else if (opt == 's')
+            sort_inputs = true;
+        else if (opt == 'i')
+            virtual_processes = true;
+        else if (opt == 'w')
+            pool_size = optarg;
+    }
+    if (argc - optind < 3 || (virtual_processes && pool_size))
+    {
+        printf("Use: ./process_generator <algorithm|plugin_path> <quantum> <file_path>... [-v] [-t <tick_period>] [-r] [-s] "
+               "[-i | -w <workers>]\n");
+        exit(EXIT_FAILURE);
+    }
+
     // TODO Initialization
     // 1. Read the input files.
-    read_input_file(processes_queue, argv[3]);
+    read_input_file(&workload, argv + optind + 2, argc - optind - 2);
 
     // 2. Ask the user for the chosen scheduling algorithm and its parameters, if there are any.
-    int algorithm_choosen = atoi(argv[1]), quantum_time = atoi(argv[2]);
+    char *algorithm_choosen = argv[optind], *quantum_time = argv[optind + 1];
     // get_scheduling_algo(&algorithm_choosen, &quantum_time);
 
     // 3. Initiate and create the scheduler and clock processes.
-    int clk_id = start_program(clk_file_name, 0);
-    scheduler_id = start_program(scheduler_file_name, 2, algorithm_choosen, quantum_time);
+    int clk_id = virtual_time ? start_program(clk_file_name, 3, "-v", "-t", tick_period)
+                              : start_program(clk_file_name, 2, "-t", tick_period);
+    if (transport == ARRIVAL_RING)
+    {
+        // the ring has to exist before the scheduler attaches to it
+        arrival_ring = arrival_ring_create(ARRIVAL_RING_SHKEY, ARRIVAL_RING_CAPACITY);
+        if (arrival_ring == NULL)
+            exit(-1);
+    }
+    char *arrivals = transport == ARRIVAL_RING ? "ring" : "msgq";
+    if (pool_size)
+        scheduler_id = start_program(scheduler_file_name, 5, algorithm_choosen, quantum_time, arrivals, "pool", pool_size);
+    else
+        scheduler_id = start_program(scheduler_file_name, 4, algorithm_choosen, quantum_time, arrivals,
+                                     virtual_processes ? "virtual" : "forked");
 
     // 4. Use this function after creating the clock process to initialize clock
     initClk();
@@ -62,31 +124,93 @@ int main(int argc, char *argv[]) // algorithm, quantum, file_path
     msgq_id = msgget(SHKEY, 0666 | IPC_CREAT);
     msgbuf_t msgbuf;
 
-    while (!is_queue_empty(processes_queue))
+    process_info_t *process_data = peek_workload_merge(&workload);
+    int last_arrival = INT_MIN;
+    while (process_data)
     {
-        process_info_t *process_data = (process_info_t *)front(processes_queue);
+        int64_t now = getClkTicks();
+        int now_time = now / CLK_TICKS_PER_UNIT;
         bool send_signal = false;
-        while (process_data && process_data->arrival == getClk())
+        msgbuf.count = 0;
+        // Everything due by now goes out, a skipped tick only delays processes
+        while (process_data && process_data->arrival <= now_time)
         {
             send_signal = true;
-
-            msgbuf.mytype = getClk();
-            msgbuf.message = (*process_data);
-
-            msgsnd(msgq_id, &msgbuf, sizeof(msgbuf.message), IPC_NOWAIT);
-
-            free((process_info_t *)dequeue(processes_queue));
-            process_data = (process_info_t *)front(processes_queue);
+            if (process_data->arrival < last_arrival && unsorted_arrivals++ == 0)
+                printf("\nProcess %d arrives at %d after a process arriving at %d, the processes file is not sorted "
+                       "by arrival and its processes are sent late. Run with -s to sort it first.\n",
+                       process_data->id, process_data->arrival, last_arrival);
+            last_arrival = process_data->arrival;
+            record_lateness(process_data, now_time);
+
+            msgbuf.processes[msgbuf.count++] = (*process_data);
+            if (msgbuf.count == ARRIVAL_BATCH_SIZE)
+                send_arrivals(&msgbuf, now_time);
+
+            delivered++;
+            pop_workload_merge(&workload);
+            process_data = peek_workload_merge(&workload);
         }
 
+        if (msgbuf.count > 0)
+            send_arrivals(&msgbuf, now_time);
         if (send_signal)
+        {
             kill(scheduler_id, SIGUSR1);
+            ringClk();
+            if (transport == ARRIVAL_RING)
+                arrival_syscalls++;
+        }
+        if (!process_data)
+            break;
+
+        // The generator has nothing to do before the next arrival, in virtual time it
+        // acknowledges every tick up to it so the clock does not wait for it meanwhile
+        int64_t next_arrival = (int64_t)process_data->arrival * CLK_TICKS_PER_UNIT;
+        if (virtual_time)
+            ackClk(CLK_GENERATOR, next_arrival - 1 > now ? next_arrival - 1 : now, next_arrival);
+        waitUntil(process_data->arrival);
     }
+    detachClk(CLK_GENERATOR);
 
-    free(processes_queue);
+    // An empty message tells the scheduler how many processes were sent
+    if (transport == ARRIVAL_MSGQ)
+    {
+        msgbuf.count = 0;
+        send_arrivals(&msgbuf, getClk());
+        kill(scheduler_id, SIGUSR1);
+        ringClk();
+    }
+    printf("Sent %ld arrivals in %ld %s calls, %.2f arrivals per syscall\n", arrivals_sent, arrival_syscalls,
+           transport == ARRIVAL_RING ? "kill" : "msgsnd",
+           arrival_syscalls ? (double)arrivals_sent / arrival_syscalls : 0.0);
+    printf("Backpressure: %ld stalls, %.3f ms blocked waiting for the scheduler\n", backpressure_stalls, blocked_ns / 1e6);
+    printf("Late arrivals: %ld of %zu, at most %d time units late\n", late_arrivals, delivered, max_late_units);
+    if (!virtual_time)
+        printf("Arrival delivery delay avg = %.3f ms max = %.3f ms\n",
+               delivered ? delivery_delay_ns / 1e6 / delivered : 0.0, max_delivery_delay_ns / 1e6);
+
+    // the reader is done by now, its stats are final
+    for (size_t i = 0; i < workload.stream_count; i++)
+    {
+        workload_stream_t *stream = &workload.streams[i];
+        double megabytes = stream->bytes / (1024.0 * 1024.0);
+        printf("Parsed %zu processes (%.2f MB %s) from %s in %.3f s, %.2f MB/s%s", stream->count, megabytes,
+               stream->format == WORKLOAD_BINARY ? "binary" : "text", stream->file_path, stream->parse_seconds,
+               stream->parse_seconds > 0 ? megabytes / stream->parse_seconds : 0.0,
+               stream->error ? ", stopped at an error" : "");
+        if (stream->unsorted > 0)
+            printf(", %zu processes out of arrival order", stream->unsorted);
+        printf("\n");
+    }
+    close_workload_merge(&workload);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("Peak RSS: %.2f MB\n", usage.ru_maxrss / 1024.0);
     killpg(getgid(), SIGKILL);
 
     kill(scheduler_id, SIGUSR2);
+    ringClk();
     pause();
 
     // 7. Clear clock resources
@@ -99,41 +223,166 @@ void clearResources(int signum)
     if (signum != 0)
         kill(scheduler_id, SIGKILL);
     msgctl(msgq_id, IPC_RMID, (struct msqid_ds *)0);
+    if (transport == ARRIVAL_RING)
+        arrival_ring_destroy(ARRIVAL_RING_SHKEY);
     exit(0);
 }
 
 /**
- * read_input_file - to read the processes and their parameters from a text file
+ * read_input_file - to start reading the processes and their parameters from text or binary files
+ *
+ * Description: Only a window of upcoming processes is kept in memory, a reader thread
+ *              per file refills it ahead of the clock while the processes are sent.
+ *              Several files are merged by arrival time, their processes renumbered.
+ *              With -s a file that is not sorted by arrival is first sorted into a
+ *              temporary binary file, unlinked as soon as it is open.
  */
-void read_input_file(queue_t *processes_queue, char *file_path)
+void read_input_file(workload_merge_t *workload, char *const file_paths[], int file_count)
 {
-    FILE *input_file;
-    // char file_path[PATH_SIZE];
-    // getAbsolutePath(file_path, "processes.txt");
-    input_file = fopen(file_path, "r");
-    if (!input_file)
+    char **paths = malloc(sizeof(char *) * file_count);
+    bool *sorted_copy = calloc(file_count, sizeof(bool));
+    if (paths == NULL || sorted_copy == NULL)
     {
-        printf("\nCould not open file processes.txt!!\n");
+        perror("Could not allocate the input files");
         exit(-1);
     }
 
-    char buffer[256];
-    while (fgets(buffer, sizeof(buffer), input_file))
+    for (int i = 0; i < file_count; i++)
     {
-        if (buffer[0] == '#')
+        paths[i] = file_paths[i];
+        if (!sort_inputs || is_workload_sorted(file_paths[i]) != 0)
             continue;
-        process_info_t *process = malloc(sizeof(process_info_t));
-        sscanf(buffer, "%d %d %d %d %d", &(process->id),
-               &(process->arrival), &(process->runtime), &(process->priority), &(process->memsize));
-        enqueue(processes_queue, (void *)process);
+
+        const char *tmp_dir = getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp";
+        int length = snprintf(NULL, 0, "%s/synergify-sorted-XXXXXX", tmp_dir);
+        paths[i] = malloc(length + 1);
+        sprintf(paths[i], "%s/synergify-sorted-XXXXXX", tmp_dir);
+        int fd = mkstemp(paths[i]);
+        workload_sort_stats_t stats;
+        if (fd == -1 || close(fd) == -1 ||
+            sort_workload(file_paths[i], paths[i], WORKLOAD_BINARY, WORKLOAD_SORT_MEMORY,
+                          sysconf(_SC_NPROCESSORS_ONLN), &stats) == -1)
+        {
+            printf("\nCould not sort %s by arrival\n", file_paths[i]);
+            unlink(paths[i]);
+            exit(-1);
+        }
+        sorted_copy[i] = true;
+        printf("Sorted %s by arrival: %zu processes in %.3f s, %zu runs, %d merge passes\n", file_paths[i],
+               stats.count, stats.seconds, stats.runs, stats.passes);
     }
-    fclose(input_file);
+
+    int result = open_workload_merge(workload, paths, file_count, WORKLOAD_STREAM_WINDOW);
+    for (int i = 0; i < file_count; i++)
+        if (sorted_copy[i])
+            unlink(paths[i]);
+    free(sorted_copy);
+    if (result == -1)
+        exit(-1);
+    // the streams report the files the user gave
+    for (int i = 0; i < file_count; i++)
+        workload->streams[i].file_path = file_paths[i];
+
+    for (size_t i = 0; i < workload->stream_count; i++)
+        printf("Streaming %s (%.2f MB %s)\n", file_paths[i], workload->streams[i].file_bytes / (1024.0 * 1024.0),
+               workload->streams[i].format == WORKLOAD_BINARY ? "binary" : "text");
+    if (file_count > 1)
+        printf("Merging %d files by arrival time, processes are renumbered in arrival order\n", file_count);
+}
+
+/**
+ * send_arrivals - sends the processes gathered in a message to the scheduler and empties it
+ * @msgbuf: the message, its count is reset to 0
+ * @now_time: the time the processes arrive at
+ *
+ * Description: Nothing is dropped: when the message queue or the ring is full the
+ *              scheduler is kicked to drain it and the generator waits for room.
+ */
+void send_arrivals(msgbuf_t *msgbuf, int now_time)
+{
+    if (transport == ARRIVAL_RING)
+    {
+        size_t pushed = arrival_ring_push(arrival_ring, msgbuf->processes, msgbuf->count);
+        while (pushed < (size_t)msgbuf->count)
+        {
+            wait_for_scheduler();
+            pushed += arrival_ring_push(arrival_ring, msgbuf->processes + pushed, msgbuf->count - pushed);
+        }
+    }
+    else
+    {
+        msgbuf->mytype = now_time + 1;
+        msgbuf->seq = arrivals_sent;
+        arrival_syscalls++;
+        while (msgsnd(msgq_id, msgbuf, MSGBUF_SIZE(msgbuf->count), IPC_NOWAIT) == -1)
+        {
+            if (errno != EAGAIN && errno != EINTR)
+            {
+                perror("Error in sending arrivals to the scheduler");
+                exit(-1);
+            }
+            wait_for_scheduler();
+            arrival_syscalls++;
+        }
+    }
+    arrivals_sent += msgbuf->count;
+    msgbuf->count = 0;
+}
+
+/**
+ * record_lateness - accounts for how late a process is sent compared with its arrival time
+ * @process: the process being sent
+ * @now_time: the time it is sent at
+ *
+ * Description: In real time the delay is also measured in wall time from the start of
+ *              the process's arrival tick, in virtual time only the time units count.
+ */
+void record_lateness(process_info_t *process, int now_time)
+{
+    int late_units = now_time - process->arrival;
+    if (late_units > 0)
+        late_arrivals++;
+    if (late_units > max_late_units)
+        max_late_units = late_units;
+
+    if (isVirtualClk())
+        return;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t arrival_ns = shmaddr->epoch_ns + (int64_t)process->arrival * CLK_TICKS_PER_UNIT * shmaddr->tick_ns;
+    int64_t delay = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec - arrival_ns;
+    if (delay < 0)
+        delay = 0;
+    delivery_delay_ns += delay;
+    if (delay > max_delivery_delay_ns)
+        max_delivery_delay_ns = delay;
+}
+
+/**
+ * wait_for_scheduler - kicks the scheduler to drain the arrivals and sleeps a little
+ *
+ * Description: The scheduler only reads arrivals when it gets SIGUSR1, so it has to be
+ *              kicked before waiting for room, every wait counts as a backpressure stall.
+ */
+void wait_for_scheduler()
+{
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    kill(scheduler_id, SIGUSR1);
+    ringClk();
+    arrival_syscalls++;
+    usleep(100);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    backpressure_stalls++;
+    blocked_ns += (end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec);
 }
 
 /**
  * get_scheduling_algo - read the scheduling algo and its parameters
  * @algorithm_choosen: a pointer to store the chosen algo
- * @quantum_time: a pointer to store the round robin quantum if it was choosen
+ * @quantum_time: a pointer to store the round robin quantum or the CFS target latency if one was choosen
  */
 void get_scheduling_algo(int *algorithm_choosen, int *quantum_time)
 {
@@ -143,10 +392,11 @@ read_algo:
     printf("1 for Non-preemptive Highest Priority First\n");
     printf("2 for Shortest Remaining time Next\n");
     printf("3 for Round Robin\n");
+    printf("4 for Completely Fair Scheduler\n");
     printf("Your choice: ");
 
     scanf("%d", algorithm_choosen);
-    if ((*algorithm_choosen) < 1 || (*algorithm_choosen) > 3)
+    if ((*algorithm_choosen) < 1 || (*algorithm_choosen) > 4)
     {
         printf("\nInvalid input, try again\n\n");
         goto read_algo;
@@ -158,6 +408,11 @@ read_quantum:
         printf("\nEnter the quantum size of Round Robin: ");
         scanf("%d", quantum_time);
     }
+    else if ((*algorithm_choosen) == 4)
+    {
+        printf("\nEnter the target latency of the Completely Fair Scheduler: ");
+        scanf("%d", quantum_time);
+    }
 
     if ((*quantum_time) < 0)
     {
@@ -170,12 +425,8 @@ read_quantum:
  * start_program - creates a new process and executes the passed file_name.
  *
  * @file_name: the name of the file (program) to execute.
- * @n: number of variadic arguments.
+ * @n: number of variadic arguments, each one is a string passed to the program.
  * @return: the forked process id.
- *
- * Description: If the program to execute is the scheduler, then take another 2 arguments and convert
- * them from an int to a string and pass them to it as an input, else if its any other program then
- * execute it normally.
  */
 int start_program(const char *const file_name, int n, ...)
 {
@@ -193,24 +444,16 @@ int start_program(const char *const file_name, int n, ...)
         // get the current working directory.
         getAbsolutePath(absolute_path, file_name);
 
-        // if we would execute scheduler, then pass to it some arguments.
-        if (strcmp(file_name, scheduler_file_name) == 0)
-        {
-            char argv[2][10];
+        char *args[n + 2];
 
-            sprintf(argv[0], "%d", va_arg(ptr, int));
-            sprintf(argv[1], "%d", va_arg(ptr, int));
+        args[0] = (char *)file_name;
+        for (int i = 1; i <= n; i++)
+            args[i] = va_arg(ptr, char *);
+        args[n + 1] = NULL;
 
-            va_end(ptr);
+        va_end(ptr);
 
-            error = execl(absolute_path, file_name, argv[0], argv[1], NULL);
-        }
-        else
-        {
-            va_end(ptr);
-
-            error = execl(absolute_path, file_name, NULL);
-        }
+        error = execv(absolute_path, args);
 
         if (error == -1)
         {
@@ -0,0 +1,50 @@
+#include "process_table.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+process_table_t *process_table_create(key_t key, uint32_t capacity)
+{
+    // a segment left over by an earlier run may have another size
+    process_table_destroy(key);
+    int shmid = shmget(key, sizeof(process_table_t) + capacity * sizeof(process_slot_t), IPC_CREAT | 0666);
+    if (shmid == -1)
+    {
+        perror("Error in creating the process table");
+        return NULL;
+    }
+    process_table_t *table = (process_table_t *)shmat(shmid, NULL, 0);
+    if ((long)table == -1)
+    {
+        perror("Error in attaching the process table");
+        return NULL;
+    }
+
+    memset(table->slots, 0, capacity * sizeof(process_slot_t));
+    table->capacity = capacity;
+    return table;
+}
+
+process_table_t *process_table_attach(key_t key)
+{
+    int shmid = shmget(key, 0, 0666);
+    if (shmid == -1)
+        return NULL;
+    process_table_t *table = (process_table_t *)shmat(shmid, NULL, 0);
+    if ((long)table == -1)
+        return NULL;
+    return table;
+}
+
+void process_table_detach(process_table_t *table)
+{
+    shmdt(table);
+}
+
+void process_table_destroy(key_t key)
+{
+    int shmid = shmget(key, 0, 0666);
+    if (shmid != -1)
+        shmctl(shmid, IPC_RMID, NULL);
+}
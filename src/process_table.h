@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#define PROCESS_TABLE_SHKEY 600
+#define PROCESS_TABLE_CAPACITY (1 << 15) /* slots, as many process.out as a default pid_max lets live */
+#define PROCESS_TABLE_CACHE_LINE 64
+
+/**
+ * struct process_slot_s - What a process.out shares with the scheduler
+ * @pid: pid of the process.out, written by the scheduler when it spawns it
+ * @job_seq: bumped by the scheduler every time it hands a pooled worker a job
+ * @job_id: file id of the job
+ * @runtime: running time of the job
+ * @remaining_time: time units the job has left, written by process.out every time unit it runs
+ * @state: process_state of the job, RUNNING or READY, written by process.out on dispatch and stop
+ * @last_run: tick of the last time unit the job ran for
+ *
+ * Description: The scheduler fills the job in before its first dispatch, a pooled
+ *              worker reads it when that SIGCONT comes in. Then process.out reports
+ *              every time unit it runs by writing its slot, the scheduler reads it
+ *              on its own tick. Each slot has a cache line of its own so a process
+ *              only ever touches its own line.
+ */
+typedef struct process_slot_s
+{
+    volatile pid_t pid;
+    volatile uint32_t job_seq;
+    volatile int job_id;
+    volatile int runtime;
+    volatile int remaining_time;
+    volatile int state;
+    volatile int64_t last_run;
+} __attribute__((aligned(PROCESS_TABLE_CACHE_LINE))) process_slot_t;
+
+/**
+ * struct process_table_s - The shared memory segment of the process.out slots
+ * @capacity: number of slots
+ * @slots: one slot per live process.out, handed out by the scheduler
+ */
+typedef struct process_table_s
+{
+    uint32_t capacity;
+    process_slot_t slots[] __attribute__((aligned(PROCESS_TABLE_CACHE_LINE)));
+} process_table_t;
+
+/**
+ * process_table_create - creates the shared memory segment of the table and attaches it.
+ * @param key: the SysV key of the segment.
+ * @param capacity: number of slots.
+ * @return the attached table, or NULL on failure.
+ */
+process_table_t *process_table_create(key_t key, uint32_t capacity);
+
+/**
+ * process_table_attach - attaches a table created by process_table_create().
+ * @param key: the SysV key of the segment.
+ * @return the attached table, or NULL if it does not exist.
+ */
+process_table_t *process_table_attach(key_t key);
+
+/**
+ * process_table_detach - detaches the table, the last one to detach after
+ *                        process_table_destroy() frees the segment.
+ * @param table: the table.
+ */
+void process_table_detach(process_table_t *table);
+
+/**
+ * process_table_destroy - marks the segment of the table for removal.
+ * @param key: the SysV key of the segment.
+ */
+void process_table_destroy(key_t key);
@@ -1,28 +1,60 @@
 #include "clk.h"
 #include "header.h"
+#include "policy.h"
 #include "gui/gui.h"
-#include "ds/fib_heap.h"
 #include "ds/queue.h"
 #include "buddy_memory.h"
+#include "arrival_ring.h"
+#include "process_table.h"
 #include <math.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <sys/pidfd.h>
+#include <sys/resource.h>
+
+#define EVENT_BATCH_SIZE 64 /* epoll events and signals read at once */
+#define EVENT_SIGNALS 0     /* tag of the signalfd in the epoll set */
+#define EVENT_TICK 1        /* tag of the timerfd */
+#define EVENT_EXIT 2        /* tag of a process.out pidfd, the fd is in the low half */
+
+extern char **environ;
 
 //================================= SIGNAL HANDLERS =================================//
 static void initializeProcesses(int signum);
-static void terminateRunningProcess(int signum);
 static void noMoreProcesses(int signum);
 static void clearResources(int signum);
-static void processDecremented(int signum);
+static void completeProcess(int slot);
+static void finishRunningProcess();
+static void finishProcess(PCB *process);
 
 //=============================== SCHEDULER FUNCTIONS ===============================//
-static void *allocateDataStructure(scheduling_algo selected_algo);
-static PCB *getRunningProcess(scheduling_algo selected_algo);
-static PCB *popRunningProcess(scheduling_algo selected_algo);
-static short is_running_queue_empty(scheduling_algo selected_algo);
+static PCB *getRunningProcess();
 static void generateProcesses();
+static void admitArrival(process_info_t *message);
 static void addToStateQueue(PCB *process);
 static void addToBlockQueue(PCB *process);
 static void addToReadyQueue(PCB *process);
 static void checkBlockQueue();
+static void runVirtualProcess(int curr_time);
+static void initLauncher();
+static pid_t spawnProcess(char *const args[]);
+static void waitUntilReady(int64_t spawned_ns);
+static int takeSlot();
+static void collectReports();
+static void spawnWorker();
+static void handJob(PCB *process);
+static void stopWorkers();
+static void initEventLoop();
+static void watchProcess(pid_t pid);
+static void handleEvents();
+static void handleSignals();
+static void waitForEvents(uint32_t seen_events, int64_t curr_ticks);
+static bool has_pending_work();
+static bool has_pending_arrivals();
+static void syncVirtualClk(int64_t curr_ticks);
+static void publishSchedulerStatus(int64_t curr_ticks);
 SchedulerConfig *getSchedulerConfigInstance();
 
 //====================================== GUI ========================================//
@@ -30,6 +62,8 @@ void createTaskManager(pthread_t *gui_thread);
 
 //==================================== LOG DATA =====================================//
 static float calculate_std_wta();
+static int compare_ints(const void *a, const void *b);
+static int calculate_p99_waiting();
 static void addPerf(FILE *file);
 static void addFinishLog(FILE *file, int currentTime, int processId,
                          char *state, int arrivalTime, int totalRuntime,
@@ -37,23 +71,68 @@ static void addFinishLog(FILE *file, int currentTime, int processId,
 static void addToMemoryLog(FILE *memoryLog, int time, int bytes, int id, int i, int j, bool isAllocated);
 
 //====================== GLOBAL VARIABLES (scheduelr related) =======================//
-void *ready_queue = NULL;
+const policy_t *policy = NULL; // runs the selected scheduling algorithm
+void *ready_queue = NULL;       // the ready structure of the policy
 buddy_tree_t *buddy_system_tree = NULL;
 queue_t *queue = NULL, *block_queue = NULL;
 bool endScheduler = false;
 PCB *running_process = NULL;
-int selectedAlgorithmIndex;
-void (*scheduleFunction[])(void *) = {scheduleHPF, scheduleSRTN, scheduleRR};
+bool interrupted = false;     // SIGINT was received
+int event_fd = -1;            // epoll set the main loop sleeps on in real-time mode
+int signal_fd = -1;           // the signals sent to the scheduler, none of them has a handler
+int tick_fd = -1;             // timer armed at the next tick of the real-time clock
+bool sweep_exits = false;     // a process.out got no pidfd, exited ones are swept up instead
+arrival_transport transport = ARRIVAL_MSGQ;
+arrival_ring_t *arrival_ring = NULL;
+bool virtual_processes = false; // processes are run by the scheduler instead of being forked
+int last_run_time = -1;         // last time unit the running virtual process was accounted for
+process_table_t *process_table = NULL; // slots the process.out report through, NULL for virtual processes
+int *free_slots = NULL;                // slots of the table no process.out holds
+int free_count = 0;
+bool pooled = false;                   // processes are run by pooled process.out workers
+PCB **slot_processes = NULL;           // process each slot of the table is running, to find the finisher
+int *idle_workers = NULL;              // slots of the workers waiting for a job
+int idle_count = 0;
+int worker_count = 0;                  // workers spawned so far
+char process_path[PATH_SIZE];          // resolved path of process.out
+char process_args[5][12];              // id, arrival, runtime, priority and slot of the process being spawned
+char *process_argv[7];                 // argv of a spawned process.out, pointing to the buffers above
+posix_spawnattr_t spawn_attributes;
+
+//================== GLOBAL VARIABLES (virtual-time clock related) ==================//
+int reports_handled = 0;                   // process reports applied by the main loop
+int expected_acks = 0;                     // stop/continue signals sent to processes
+int reports_base = 0;                      // process reports seen when the last time was acknowledged
+bool was_running = false;                  // a process was running when the last time was acknowledged
+int64_t acked_ticks = -1;                  // last tick acknowledged to the clock
 
 //====================== GLOBAL VARIABLES (log file related) =======================//
 float total_waiting_time = 0;             // sum of waiting times
 float total_weighted_turnaround_time = 0; // sum of weighted turnaround times
 float total_running_time = 0;             // sum of running times
+double total_squared_wta = 0;             // sum of squared weighted turnaround times
 float *wta_values = NULL;                 // array of weighted turnaround times
+int *waiting_values = NULL;               // array of waiting times, for their percentiles
+double total_service_rate = 0;            // sum of runtime / turnaround, for Jain's fairness index
+double total_squared_service_rate = 0;    // sum of squared runtime / turnaround
+int service_rate_count = 0;               // processes with a running time, the only ones in the index
 int free_mem = 1024;
 int total_processes = 0; // total number of processes that come so far
 int idx = 0;             // index of the wta_values array
 int waste_time = 0;      // cpu wasted time
+long arrivals_received = 0; // processes received from the generator
+long arrival_syscalls = 0;  // msgrcv calls (or SIGUSR1 kicks with the ring) made to receive them
+long next_arrival_seq = 0;  // sequence number the next arrival message should start at
+long arrival_gaps = 0;      // messages that did not continue the previous one
+long lost_arrivals = 0;     // processes missing in those gaps
+long process_forks = 0;     // spawns of a process.out, one per process or per pooled worker
+clk_latency_t spawn_latency; // wall time from spawning a process.out to it being ready
+long pooled_jobs = 0;       // processes handed to a pooled worker
+clk_latency_t start_latency; // wall time from receiving a process to its first dispatch
+long completions = 0;        // completion signals taken off the queue
+long late_completions = 0;   // completions of a process that was no longer at the front
+clk_latency_t dispatch_latency; // wall time from a switching tick to the new process being continued
+long event_wakeups = 0;      // times the main loop woke up
 FILE *logFile, *perfFile, *memoryLog;
 
 const char *const SCHEDULER_LOG_NAME = "scheduler.log";
@@ -62,11 +141,23 @@ const char *const MEMORY_LOG_NAME = "memory.log";
 
 int main(int argc, char *argv[])
 {
-    if (argc != 3)
+    if (argc < 3 || argc > 6 || (argc == 6 && strcmp(argv[4], "pool") != 0))
     {
-        perror("Use: ./scheduler <scheduling_algo> <quantum>");
+        perror("Use: ./scheduler <scheduling_algo|plugin_path> <quantum> [msgq|ring] [forked|virtual|pool <workers>]");
         exit(EXIT_FAILURE);
     }
+    if (argc >= 5 && strcmp(argv[4], "virtual") == 0)
+        virtual_processes = true;
+    if (argc >= 4 && strcmp(argv[3], "ring") == 0)
+    {
+        transport = ARRIVAL_RING;
+        arrival_ring = arrival_ring_attach(ARRIVAL_RING_SHKEY);
+        if (arrival_ring == NULL)
+        {
+            perror("Error in attaching the arrival ring");
+            exit(EXIT_FAILURE);
+        }
+    }
 
     /* Open output files */
     logFile = fopen(SCHEDULER_LOG_NAME, "w");
@@ -91,70 +182,149 @@ int main(int argc, char *argv[])
 
     wta_values = malloc(sizeof(float) * total_processes);
 
-    // Set signal handlers for process initialization and termination
-    signal(SIGUSR1, initializeProcesses);
-    signal(SIGUSR2, noMoreProcesses);
-    signal(SIGALRM, terminateRunningProcess);
-    signal(SIGINT, clearResources);
-    signal(SIGPWR, processDecremented);
-
     // Get instance of scheduler configuration and set it
     SchedulerConfig *schedulerConfig = getSchedulerConfigInstance();
     schedulerConfig->selected_algorithm = (scheduling_algo)atoi(argv[1]);
-    schedulerConfig->quantum = atoi(argv[2]);
-    schedulerConfig->curr_quantum = schedulerConfig->quantum;
-
-    selectedAlgorithmIndex = schedulerConfig->selected_algorithm - 1;
+    // The quantum of RR, or the target latency and minimum granularity of CFS as "latency,granularity"
+    sscanf(argv[2], "%d,%d", &schedulerConfig->quantum, &schedulerConfig->min_granularity);
+    // The algorithm is either the number of a built-in one or the path of a plugin
+    if (strchr(argv[1], '/') != NULL)
+        policy = loadPolicy(argv[1]);
+    else if ((policy = getPolicy(schedulerConfig->selected_algorithm)) == NULL)
+        printf("Unknown scheduling algorithm %s\n", argv[1]);
+    if (policy == NULL)
+        exit(EXIT_FAILURE);
+    schedulerConfig->policy = policy;
 
     int prev_time = -1;
-    float prev_time_float = -.5;
+    int64_t prev_ticks = -1;
 
-    // Allocate the data structure depending on the selected algorithm
+    // Allocate the ready structure of the selected algorithm
     buddy_system_tree = create_buddy_tree();
-    ready_queue = allocateDataStructure(schedulerConfig->selected_algorithm);
+    ready_queue = policy->init(schedulerConfig);
     block_queue = create_queue();
     queue = create_queue();
 
+    // Signals are read by the main loop, the GUI thread inherits the mask and never gets them
+    initEventLoop();
+
     // Create task manager gui
     pthread_t gui_thread;
     createTaskManager(&gui_thread);
 
     initClk();
+    initLauncher();
 
-    while (1)
+    // Every process.out reports the time units it runs through its slot of the process table
+    if (!virtual_processes)
     {
-        int curr_time = getClk();
-        float curr_time_float = getClkFloat();
-        generateProcesses();
+        process_table = process_table_create(PROCESS_TABLE_SHKEY, PROCESS_TABLE_CAPACITY);
+        if (process_table == NULL)
+            exit(EXIT_FAILURE);
+        free_slots = malloc(sizeof(int) * PROCESS_TABLE_CAPACITY);
+        slot_processes = calloc(PROCESS_TABLE_CAPACITY, sizeof(PCB *));
+        for (int i = PROCESS_TABLE_CAPACITY - 1; i >= 0; i--)
+            free_slots[free_count++] = i;
+    }
 
-        if (curr_time_float - prev_time_float == 1)
+    // The pooled workers are spawned up front, the pool only grows if they are all busy
+    if (argc == 6)
+    {
+        pooled = true;
+        idle_workers = malloc(sizeof(int) * PROCESS_TABLE_CAPACITY);
+        int pool_size = atoi(argv[5]);
+        for (int i = 0; i < pool_size && i < PROCESS_TABLE_CAPACITY; i++)
+            spawnWorker();
+    }
+
+    while (1)
+    {
+        // every signal sent to the scheduler is followed by an event, so
+        // anything that happens after this read cuts the wait below short
+        uint32_t seen_events = getClkEvents();
+        handleEvents();
+        collectReports();
+
+        int64_t curr_ticks = getClkTicks();
+        int curr_time = curr_ticks / CLK_TICKS_PER_UNIT;
+        // The running process reports the new time unit before new arrivals take memory
+        if (virtual_processes)
+            runVirtualProcess(curr_time);
+        // In virtual time arrivals are admitted once the running process has reported
+        if (!isVirtualClk())
+            generateProcesses();
+
+        // Processes are switched half way through each time unit
+        if (curr_ticks != prev_ticks && curr_ticks % CLK_TICKS_PER_UNIT == CLK_TICKS_PER_UNIT / 2)
         {
-            PCB *front_process = getRunningProcess(schedulerConfig->selected_algorithm);
+            // the time units the running process ran are counted before it may be stopped
+            collectReports();
+            PCB *front_process = getRunningProcess();
 
-            if (((running_process != NULL) != (front_process != NULL)) ||
-                (running_process && running_process->fork_id != front_process->fork_id))
+            if (running_process != front_process)
             {
+                if (front_process != NULL && front_process->state == NEWBIE)
+                {
+                    int64_t latency = monotonicNs() - front_process->received_ns;
+                    start_latency.count++;
+                    start_latency.total_ns += latency;
+                    if (latency > start_latency.max_ns)
+                        start_latency.max_ns = latency;
+                    if (pooled)
+                        handJob(front_process);
+                }
+                if (front_process != NULL && !virtual_processes)
+                    expected_acks += (running_process != NULL) + 1;
                 contentSwitch(front_process, running_process, getClk(), logFile);
+                if (front_process != NULL)
+                {
+                    int64_t latency = monotonicNs() - shmaddr->tick_stamp_ns;
+                    dispatch_latency.count++;
+                    dispatch_latency.total_ns += latency;
+                    if (latency > dispatch_latency.max_ns)
+                        dispatch_latency.max_ns = latency;
+                }
+                if (running_process != NULL)
+                    policy->on_preempt(ready_queue, running_process);
                 running_process = front_process;
-                if (selectedAlgorithmIndex == RR)
-                    schedulerConfig->curr_quantum = schedulerConfig->quantum;
                 curr_time = getClk();
+                // a virtual process runs from here on, and like process.out
+                // one with no running time finishes as soon as it is dispatched
+                last_run_time = curr_time;
+                if (virtual_processes && running_process && running_process->remaining_time == 0)
+                    finishRunningProcess();
             }
 
-            prev_time_float = curr_time_float;
+            prev_ticks = curr_ticks;
         }
 
         // Run selected algorithm if the clock has ticked
         if (curr_time != prev_time)
         {
-            PCB *front_process = getRunningProcess(schedulerConfig->selected_algorithm);
+            PCB *front_process = getRunningProcess();
             prev_time = curr_time;
         }
 
-        if (is_running_queue_empty(schedulerConfig->selected_algorithm) && is_queue_empty(queue) && endScheduler)
+        if ((policy->size(ready_queue) == 0 && is_queue_empty(queue) && endScheduler) ||
+            interrupted)
         {
             break;
         }
+
+        if (isVirtualClk())
+            syncVirtualClk(curr_ticks);
+
+        publishSchedulerStatus(curr_ticks);
+        waitForEvents(seen_events, curr_ticks);
+    }
+    detachClk(CLK_SCHEDULER);
+    stopWorkers();
+    if (process_table != NULL)
+    {
+        process_table_detach(process_table);
+        process_table_destroy(PROCESS_TABLE_SHKEY);
+        free(free_slots);
+        free(slot_processes);
     }
 
     addPerf(perfFile);
@@ -181,54 +351,103 @@ int main(int argc, char *argv[])
 /**
  * initializeProcesses - Initializes processes based on the number of processes to be created.
  *
- * Description: On a received signal from the generator, initializes processes, forks them,
- *              and adds them to the ready queue.
+ * Description: On a SIGUSR1 from the generator, receives the processes it sent and
+ *              queues them to be forked and added to the ready queue.
  */
 static void initializeProcesses(int signum)
 {
     int msgQId = msgget(SHKEY, 0666 | IPC_CREAT);
     msgbuf_t msgbuf;
 
-    while (msgrcv(msgQId, &msgbuf, sizeof(msgbuf.message), 0, IPC_NOWAIT) != -1)
-    {
-        PCB *process = NULL;
-        process = malloc(sizeof(PCB));
-        process->file_id = msgbuf.message.id;
-        process->arrival = process->last_stop_time = msgbuf.message.arrival;
-        process->runtime = msgbuf.message.runtime;
-        process->priority = msgbuf.message.priority;
-        process->start_time = -1;
-        process->waiting_time = 0;
-        process->memsize = msgbuf.message.memsize;
-        process->ptr_mem = NULL;
-        // TODO: allocate a new memory with size msgbuf.message.memsize and assign it to the process
-
-        enqueue(queue, (void *)process);
+    if (transport == ARRIVAL_RING)
+    {
+        // one kick may cover several time units, drain everything pushed so far
+        arrival_syscalls++;
+        while ((msgbuf.count = arrival_ring_pop(arrival_ring, msgbuf.processes, ARRIVAL_BATCH_SIZE)) > 0)
+        {
+            for (int i = 0; i < msgbuf.count; i++)
+                admitArrival(&msgbuf.processes[i]);
+            arrivals_received += msgbuf.count;
+        }
+    }
+    else
+    {
+        while (1)
+        {
+            arrival_syscalls++;
+            if (msgrcv(msgQId, &msgbuf, MSGBUF_SIZE(ARRIVAL_BATCH_SIZE), 0, IPC_NOWAIT) == -1)
+                break;
+            if (msgbuf.seq != next_arrival_seq)
+            {
+                printf("Arrivals %ld to %ld were lost\n", next_arrival_seq, msgbuf.seq - 1);
+                arrival_gaps++;
+                lost_arrivals += msgbuf.seq - next_arrival_seq;
+            }
+            next_arrival_seq = msgbuf.seq + msgbuf.count;
+            for (int i = 0; i < msgbuf.count; i++)
+                admitArrival(&msgbuf.processes[i]);
+            arrivals_received += msgbuf.count;
+        }
     }
+}
+
+/**
+ * admitArrival - Creates the PCB of an arriving process and queues it to be forked
+ * @param message: The process as sent by the generator
+ */
+static void admitArrival(process_info_t *message)
+{
+    PCB *process = NULL;
+    process = malloc(sizeof(PCB));
+    process->file_id = message->id;
+    process->arrival = process->last_stop_time = message->arrival;
+    process->runtime = process->remaining_time = message->runtime;
+    process->priority = message->priority;
+    process->start_time = -1;
+    process->waiting_time = 0;
+    process->memsize = message->memsize;
+    process->ptr_mem = NULL;
+    process->slot = -1;
+    process->received_ns = monotonicNs();
+    process->vruntime = 0;
+    // TODO: allocate a new memory with size message->memsize and assign it to the process
+
+    enqueue(queue, (void *)process);
+}
 
-    signal(SIGUSR1, initializeProcesses);
+/**
+ * finishRunningProcess - Removes the running process from the ready queue and logs its finish
+ */
+static void finishRunningProcess()
+{
+    PCB *process = policy->on_finish(ready_queue);
+    running_process = NULL;
+    finishProcess(process);
+    free(process);
 }
 
 /**
- * terminateRunningProcess - Terminates the currently running process
+ * finishProcess - Logs the finish of a process and releases what it holds
+ * @param process: The process, it is left to the caller to free
  *
- * @param signum: The signal number that triggered the termination.
- *
- * Description: Waits for the currently running process to terminate and then removes
- *              it from the ready queue.
+ * Description: Its memory is freed and handed to the blocked processes that fit in it,
+ *              its slot of the process table is freed or, for a pooled worker, the
+ *              worker waits for another job.
  */
-static void terminateRunningProcess(int signum)
+static void finishProcess(PCB *process)
 {
-    SchedulerConfig *schedulerConfig = getSchedulerConfigInstance();
-    scheduling_algo selected_algo = schedulerConfig->selected_algorithm;
-    schedulerConfig->curr_quantum = schedulerConfig->quantum;
-
-    int stat_loc;
-    PCB *process = popRunningProcess(selected_algo);
-    pid_t process_id = process->fork_id;
+    if (process->slot != -1)
+    {
+        slot_processes[process->slot] = NULL;
+        if (pooled)
+            idle_workers[idle_count++] = process->slot;
+        else
+            free_slots[free_count++] = process->slot;
+    }
 
     wta_values = realloc(wta_values, sizeof(float) * total_processes);
-    if (wta_values == NULL)
+    waiting_values = realloc(waiting_values, sizeof(int) * total_processes);
+    if (wta_values == NULL || waiting_values == NULL)
     {
         perror("Can not resize the array of WTA values");
         exit(EXIT_FAILURE);
@@ -237,35 +456,36 @@ static void terminateRunningProcess(int signum)
     wta_values[idx] = (process->runtime == 0) ? 0 : (float)(getClk() - process->arrival) / process->runtime;
 
     total_waiting_time += process->waiting_time;
-    total_weighted_turnaround_time += wta_values[idx++];
+    waiting_values[idx] = process->waiting_time;
+    if (process->runtime > 0 && getClk() > process->arrival)
+    {
+        double service_rate = (double)process->runtime / (getClk() - process->arrival);
+        total_service_rate += service_rate;
+        total_squared_service_rate += service_rate * service_rate;
+        service_rate_count++;
+    }
+    total_weighted_turnaround_time += wta_values[idx];
+    total_squared_wta += wta_values[idx] * wta_values[idx];
+    idx++;
     total_running_time += process->runtime;
-    float WTA = (running_process->runtime == 0) ? 0 : (float)(getClk() - running_process->arrival) / running_process->runtime;
+    float WTA = (process->runtime == 0) ? 0 : (float)(getClk() - process->arrival) / process->runtime;
     addFinishLog(logFile,
                  getClk(),
-                 running_process->file_id,
+                 process->file_id,
                  "finished",
-                 running_process->arrival,
-                 running_process->runtime,
-                 running_process->waiting_time,
-                 getClk() - running_process->arrival,
+                 process->arrival,
+                 process->runtime,
+                 process->waiting_time,
+                 getClk() - process->arrival,
                  WTA);
 
     // TODO: Free allocate memory for the process from the buddy system.
-    buddy_node_t *buddy_node = (buddy_node_t *)running_process->ptr_mem;
+    buddy_node_t *buddy_node = (buddy_node_t *)process->ptr_mem;
     free_mem += pow(2, ceil(log2(process->memsize)));
     printf("free_mem: %d\n", free_mem);
     addToMemoryLog(memoryLog, getClk(), process->memsize, process->file_id, buddy_node->i, buddy_node->j, false);
     free_memory(buddy_node);
-    free(running_process);
-
-    running_process = NULL;
     checkBlockQueue();
-
-    printf("block:\n");
-    queue_print(block_queue);
-
-    waitpid(process_id, &stat_loc, 0);
-    signal(SIGALRM, terminateRunningProcess);
 }
 
 /**
@@ -284,19 +504,13 @@ static void noMoreProcesses(int signum)
  * clearResources - Deallocates resources used by the scheduler
  * @param signum: The signal number
  *
- * This function is a signal handler for cleaning up resources when SIGINT (Ctrl+C) is received.
+ * This function cleans up resources once the main loop is done, which a SIGINT (Ctrl+C) cuts short.
  * It deallocates the data structures used by the scheduler, closes opened files, and prints a message.
  */
 static void clearResources(int signum)
 {
-    SchedulerConfig *schedulerConfig = getSchedulerConfigInstance();
-    scheduling_algo selected_algo = schedulerConfig->selected_algorithm;
-
     // Deallocate the data structures
-    if (selected_algo == RR)
-        queue_free((queue_t *)ready_queue, true);
-    else
-        fib_heap_free((fib_heap_t *)ready_queue, 1);
+    policy->destroy(ready_queue);
     queue_free(queue, true);
     queue_free(block_queue, true);
     buddy_free(buddy_system_tree, true);
@@ -309,129 +523,74 @@ static void clearResources(int signum)
     killpg(getgid(), SIGINT);
 }
 
-/**
- * processDecremented - Decrement the time for the current running process.
- * @param signum: Signal number.
- */
-static void processDecremented(int signum)
-{
-    scheduleFunction[selectedAlgorithmIndex](ready_queue);
-    signal(SIGPWR, processDecremented);
-}
-
 //=============================== SCHEDULER FUNCTIONS ===============================//
 
 /**
- * allocateDataStructure - Allocates and returns a data structure based on the selected scheduling algorithm
- * @param selected_algo: The selected scheduling algorithm (RR for Round Robin, others for other algorithms)
- * @return A void pointer to the allocated data structure
- *
- * This function allocates a data structure based on the selected scheduling algorithm.
- * For Round Robin (RR), it allocates a queue. For other algorithms, it allocates a Fibonacci heap.
- */
-static void *allocateDataStructure(scheduling_algo selected_algo)
-{
-    if (selected_algo == RR)
-        return (void *)create_queue();
-    else
-        return (void *)fib_heap_alloc();
-}
-
-/**
- * getRunningProcess - Retrieves the running process from the ready queue based on the selected algorithm
- * @param selected_algo: The selected scheduling algorithm (RR for Round Robin, others for other algorithms)
+ * getRunningProcess - Retrieves the process the policy picks to run
  * @return A pointer to the running process
  *
- * This function retrieves the running process from the ready queue based on the selected scheduling algorithm.
- * For Round Robin (RR), it returns the front of the queue. For other algorithms, it returns the minimum element of the Fibonacci heap.
+ * Processes that finished after being stopped are dropped once they reach the front.
  */
-static PCB *getRunningProcess(scheduling_algo selected_algo)
+static PCB *getRunningProcess()
 {
-    if (selected_algo == RR)
-        return (PCB *)front((queue_t *)ready_queue);
-    else
-        return (PCB *)fib_heap_min((fib_heap_t *)ready_queue);
-}
-
-/**
- * popRunningProcess - Removes and returns the running process from the ready queue based on the selected algorithm
- * @param selected_algo: The selected scheduling algorithm (RR for Round Robin, others for other algorithms)
- * @return A pointer to the removed running process
- *
- * This function removes and returns the running process from the ready queue based on the selected scheduling algorithm.
- * For Round Robin (RR), it dequeues the front of the queue. For other algorithms, it extracts the minimum element of the Fibonacci heap.
- */
-static PCB *popRunningProcess(scheduling_algo selected_algo)
-{
-    if (selected_algo == RR)
-        return (PCB *)dequeue((queue_t *)ready_queue);
-    else
-        return (PCB *)fib_heap_extract_min((fib_heap_t *)ready_queue);
-}
-
-/**
- * is_running_queue_empty - Checks if the running queue is empty
- * @param selected_algo: The selected scheduling algorithm
- * @return 1 if the running queue is empty, otherwise 0
- *
- * This function checks if the running queue is empty based on the selected scheduling algorithm.
- */
-static short is_running_queue_empty(scheduling_algo selected_algo)
-{
-    if (selected_algo == RR)
-        return is_queue_empty((queue_t *)ready_queue);
-    else
-        return fib_heap_size((fib_heap_t *)ready_queue) == 0;
+    while (1)
+    {
+        PCB *process = policy->pick_next(ready_queue);
+        if (process == NULL || process->state != FINISHED)
+            return process;
+        free(policy->on_finish(ready_queue));
+    }
 }
 
 /**
  * generateProcesses - Generates processes from the queue
  *
- * This function generates processes by forking and executing a program
- * with arguments based on the information stored in the queue.
+ * This function generates processes by spawning a process.out with arguments
+ * based on the information stored in the queue, each one is ready for its
+ * first dispatch before the next one is spawned.
+ * Virtual processes are admitted straight away, the scheduler runs them itself,
+ * and so are pooled processes, they get a worker on their first dispatch.
  */
 static void generateProcesses()
 {
     if (!queue)
         return;
-    char *args[6];
-
-    // Get path to the process.out
-    char absolute_path[PATH_SIZE];
-    getAbsolutePath(absolute_path, "process.out");
-
-    // Initialize the args
-    args[0] = absolute_path;
-    args[5] = NULL; // Null-terminate the argument list
-    for (int i = 1; i < 5; i++)
-        args[i] = (char *)malloc(12); // Assuming a 32-bit int can be at most 11 digits, plus 1 for null terminator
-    while (!is_queue_empty(queue))
+    // Virtual processes and processes run by pooled workers need no fork here
+    if (virtual_processes || pooled)
     {
-        PCB *process = (PCB *)dequeue(queue);
-        sprintf(args[1], "%d", process->file_id);
-        sprintf(args[2], "%d", process->arrival);
-        sprintf(args[3], "%d", process->runtime);
-        sprintf(args[4], "%d", process->priority);
-
-        pid_t pid = fork();
-        if (pid == -1)
+        while (!is_queue_empty(queue))
         {
-            // perror("Couldn't fork a process in scheduler");
-            exit(EXIT_FAILURE);
-        }
-        else if (pid == 0)
-        {
-            execvp(args[0], args);
-            perror("Couldn't use execvp");
-            exit(EXIT_FAILURE);
+            PCB *process = (PCB *)dequeue(queue);
+            process->fork_id = VIRTUAL_PROCESS;
+            process->state = NEWBIE;
+            addToStateQueue(process);
         }
-        usleep(10 * 1000);
+        return;
+    }
+    while (!is_queue_empty(queue))
+    {
+        PCB *process = (PCB *)dequeue(queue);
+        sprintf(process_args[0], "%d", process->file_id);
+        sprintf(process_args[1], "%d", process->arrival);
+        sprintf(process_args[2], "%d", process->runtime);
+        sprintf(process_args[3], "%d", process->priority);
+        int slot = takeSlot();
+        sprintf(process_args[4], "%d", slot);
+        process_table->slots[slot].job_id = process->file_id;
+        process_table->slots[slot].runtime = process_table->slots[slot].remaining_time = process->runtime;
+        process_table->slots[slot].state = NEWBIE;
+
+        int64_t spawned_ns = monotonicNs();
+        pid_t pid = spawnProcess(process_argv);
+        watchProcess(pid);
+        waitUntilReady(spawned_ns);
+        process_table->slots[slot].pid = pid;
+        slot_processes[slot] = process;
         process->fork_id = pid;
+        process->slot = slot;
         process->state = NEWBIE;
         addToStateQueue(process);
     }
-    for (int i = 1; i < 5; i++)
-        free(args[i]);
 }
 
 /**
@@ -467,32 +626,17 @@ static void addToBlockQueue(PCB *process)
 }
 
 /**
- * addToReadyQueue - Adds a process to the ready queue based on the scheduling algorithm.
+ * addToReadyQueue - Adds a process to the ready structure of the policy.
  *
  * @param process: Pointer to the process to be added.
  */
 static void addToReadyQueue(PCB *process)
 {
-    SchedulerConfig *schedulerConfig = getSchedulerConfigInstance();
-    scheduling_algo selectedAlgorithm = schedulerConfig->selected_algorithm;
-
-    switch (selectedAlgorithm)
-    {
-    case RR:
-        enqueue((queue_t *)ready_queue, (void *)process);
-        break;
-    case SRTN:
-        fib_heap_insert((fib_heap_t *)ready_queue, (void *)process, process->runtime);
-        break;
-    case HPF:
-        fib_heap_insert((fib_heap_t *)ready_queue, (void *)process, process->priority);
-    }
+    policy->enqueue(ready_queue, process);
 }
 
 static void checkBlockQueue()
 {
-    printf("before:\n");
-    queue_print(block_queue);
     queue_node_t *dummy, *parent, *delete, *iterator;
     bool isHead;
 
@@ -516,6 +660,7 @@ static void checkBlockQueue()
             if (process->ptr_mem == NULL)
             {
                 perror("freed block in buddy tree\n");
+                free(dummy);
                 return;
             }
 
@@ -529,13 +674,11 @@ static void checkBlockQueue()
             isHead = (iterator == block_queue->head);
             iterator = iterator->next;
             if (isHead)
-            {
-                printf("Blocked process is head!\n");
                 block_queue->head = iterator;
-                if (!iterator)
-                    block_queue->tail = NULL;
-                queue_print(block_queue);
-            }
+            // The tail is left behind, or the next blocked process is linked after a freed node
+            if (!iterator)
+                block_queue->tail = isHead ? NULL : parent;
+            block_queue->size--;
             free(parent->next);
             parent->next = iterator;
             continue;
@@ -547,6 +690,473 @@ static void checkBlockQueue()
     free(dummy);
 }
 
+/**
+ * runVirtualProcess - Does the work of process.out for the running virtual process
+ * @param curr_time: The current time unit
+ *
+ * Description: Each new time unit the process runs for takes one unit off its remaining
+ *              time, then it is either decremented by the scheduling algorithm or finished,
+ *              as if it had reported through its slot or its completion. A time unit that was skipped is not
+ *              counted, the same way process.out resyncs with the clock.
+ */
+static void runVirtualProcess(int curr_time)
+{
+    if (running_process == NULL || curr_time <= last_run_time)
+        return;
+    bool ran = curr_time - last_run_time == 1;
+    last_run_time = curr_time;
+    if (!ran)
+        return;
+
+    if (--running_process->remaining_time > 0)
+        policy->on_tick(ready_queue);
+    else
+        finishRunningProcess();
+}
+
+/**
+ * initLauncher - Resolves the path of process.out and prepares the spawn attributes once
+ *
+ * Description: Spawned processes start with no signal blocked, the scheduler's own
+ *              mask would keep them from being stopped.
+ */
+static void initLauncher()
+{
+    sigset_t no_signals;
+    sigemptyset(&no_signals);
+    posix_spawnattr_init(&spawn_attributes);
+    posix_spawnattr_setsigmask(&spawn_attributes, &no_signals);
+    posix_spawnattr_setflags(&spawn_attributes, POSIX_SPAWN_SETSIGMASK);
+
+    getAbsolutePath(process_path, "process.out");
+    process_argv[0] = process_path;
+    for (int i = 0; i < 5; i++)
+        process_argv[i + 1] = process_args[i];
+    process_argv[6] = NULL;
+}
+
+/**
+ * spawnProcess - Starts a process.out
+ * @param args: Its argv, args[0] being the path of process.out
+ * @return The pid of the new process
+ *
+ * Description: posix_spawn() shares the scheduler's memory until the exec instead of
+ *              copying its page tables the way fork() does.
+ */
+static pid_t spawnProcess(char *const args[])
+{
+    pid_t pid;
+    int error = posix_spawn(&pid, args[0], NULL, &spawn_attributes, args, environ);
+    if (error != 0)
+    {
+        errno = error;
+        perror("Couldn't spawn process.out");
+        exit(EXIT_FAILURE);
+    }
+    process_forks++;
+    return pid;
+}
+
+/**
+ * waitUntilReady - Waits for every spawned process.out to be attached to the clock
+ * @param spawned_ns: CLOCK_MONOTONIC time at which the last one was spawned
+ *
+ * Description: process.out counts itself ready in the clock page and rings it, so
+ *              the wait ends as soon as it can take a dispatch. Signals sent meanwhile
+ *              wait in the signalfd.
+ */
+static void waitUntilReady(int64_t spawned_ns)
+{
+    while (1)
+    {
+        uint32_t seen = getClkEvents();
+        if (shmaddr->proc_ready >= process_forks)
+            break;
+        futexWaitClk(&shmaddr->event_seq, seen);
+    }
+
+    int64_t latency = monotonicNs() - spawned_ns;
+    spawn_latency.count++;
+    spawn_latency.total_ns += latency;
+    if (latency > spawn_latency.max_ns)
+        spawn_latency.max_ns = latency;
+}
+
+/**
+ * takeSlot - Takes a free slot of the process table for a new process.out
+ * @return The index of the slot
+ */
+static int takeSlot()
+{
+    if (free_count == 0)
+    {
+        printf("All %d slots of the process table are taken\n", PROCESS_TABLE_CAPACITY);
+        exit(EXIT_FAILURE);
+    }
+    return free_slots[--free_count];
+}
+
+/**
+ * collectReports - Applies the time units the running process reported through its slot
+ *
+ * Description: process.out writes its remaining time to its slot every time unit it
+ *              runs, each unit it went down by since the last read is one decrement
+ *              for the scheduling algorithm. Reading a count instead of catching a
+ *              signal per unit means no unit is lost when several come at once. The
+ *              last unit is reported by the completion, which completeProcess() handles.
+ */
+static void collectReports()
+{
+    if (running_process == NULL || running_process->slot == -1)
+        return;
+
+    int remaining = process_table->slots[running_process->slot].remaining_time;
+    if (remaining < 1)
+        remaining = 1;
+    while (running_process->remaining_time > remaining)
+    {
+        running_process->remaining_time--;
+        policy->on_tick(ready_queue);
+        reports_handled++;
+    }
+}
+
+/**
+ * spawnWorker - Spawns a pooled process.out into a free slot of the process table and makes it idle
+ */
+static void spawnWorker()
+{
+    int slot = takeSlot();
+    char slot_arg[12];
+    sprintf(slot_arg, "%d", slot);
+    char *args[] = {process_path, "worker", slot_arg, NULL};
+
+    int64_t spawned_ns = monotonicNs();
+    pid_t pid = spawnProcess(args);
+    waitUntilReady(spawned_ns);
+    process_table->slots[slot].pid = pid;
+    idle_workers[idle_count++] = slot;
+    worker_count++;
+}
+
+/**
+ * handJob - Hands a process that is about to start to an idle pooled worker
+ * @param process: The process
+ *
+ * Description: The job is written to the worker's slot, the worker picks it up
+ *              when contentSwitch() dispatches the process to it.
+ */
+static void handJob(PCB *process)
+{
+    if (idle_count == 0)
+        spawnWorker();
+
+    int slot = idle_workers[--idle_count];
+    process_slot_t *worker = &process_table->slots[slot];
+    worker->job_id = process->file_id;
+    worker->runtime = worker->remaining_time = process->runtime;
+    worker->state = NEWBIE;
+    __atomic_store_n(&worker->job_seq, worker->job_seq + 1, __ATOMIC_RELEASE);
+
+    process->slot = slot;
+    slot_processes[slot] = process;
+    process->fork_id = worker->pid;
+    pooled_jobs++;
+}
+
+/**
+ * stopWorkers - Kills and reaps the pooled workers once every process has finished
+ */
+static void stopWorkers()
+{
+    if (!pooled)
+        return;
+
+    // every worker is idle by now
+    for (int i = 0; i < idle_count; i++)
+        kill(process_table->slots[idle_workers[i]].pid, SIGKILL);
+    for (int i = 0; i < idle_count; i++)
+        waitpid(process_table->slots[idle_workers[i]].pid, NULL, 0);
+    free(idle_workers);
+}
+
+/**
+ * initEventLoop - Routes the signals sent to the scheduler to a signalfd and sets up the epoll set
+ *
+ * Description: The signals are blocked before any thread is created, so none of them is
+ *              ever delivered to a handler: the main loop reads them from the signalfd and
+ *              is the only one that touches the queues and the buddy tree. The epoll set
+ *              holds the signalfd, a timerfd for the ticks of the real-time clock and a
+ *              pidfd per process.out to reap it without blocking.
+ */
+static void initEventLoop()
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGUSR1);
+    sigaddset(&signals, SIGUSR2);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, COMPLETION_SIGNAL);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    // one pidfd per live process.out
+    struct rlimit files;
+    getrlimit(RLIMIT_NOFILE, &files);
+    files.rlim_cur = files.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &files);
+
+    event_fd = epoll_create1(EPOLL_CLOEXEC);
+    signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    tick_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (event_fd == -1 || signal_fd == -1 || tick_fd == -1)
+    {
+        perror("Error in creating the event loop");
+        exit(EXIT_FAILURE);
+    }
+
+    struct epoll_event event = {.events = EPOLLIN};
+    event.data.u64 = (uint64_t)EVENT_SIGNALS << 32;
+    epoll_ctl(event_fd, EPOLL_CTL_ADD, signal_fd, &event);
+    event.data.u64 = (uint64_t)EVENT_TICK << 32;
+    epoll_ctl(event_fd, EPOLL_CTL_ADD, tick_fd, &event);
+}
+
+/**
+ * watchProcess - Adds a pidfd of a spawned process.out to the epoll set
+ * @param pid: Its pid
+ *
+ * Description: The pidfd becomes readable once the process exits, then it is reaped.
+ *              Without a pidfd the exited processes are swept up with WNOHANG.
+ */
+static void watchProcess(pid_t pid)
+{
+    int fd = pidfd_open(pid, 0);
+    if (fd == -1)
+    {
+        sweep_exits = true;
+        return;
+    }
+
+    struct epoll_event event = {.events = EPOLLIN};
+    event.data.u64 = (uint64_t)EVENT_EXIT << 32 | (uint32_t)fd;
+    epoll_ctl(event_fd, EPOLL_CTL_ADD, fd, &event);
+}
+
+/**
+ * handleEvents - Handles everything the epoll set has received since the last call, without blocking
+ */
+static void handleEvents()
+{
+    struct epoll_event events[EVENT_BATCH_SIZE];
+    int count;
+
+    do
+    {
+        count = epoll_wait(event_fd, events, EVENT_BATCH_SIZE, 0);
+        for (int i = 0; i < count; i++)
+        {
+            int fd = (int)(uint32_t)events[i].data.u64;
+            siginfo_t exit_info;
+            uint64_t expirations;
+
+            switch (events[i].data.u64 >> 32)
+            {
+            case EVENT_SIGNALS:
+                handleSignals();
+                break;
+            case EVENT_TICK:
+                read(tick_fd, &expirations, sizeof(expirations));
+                break;
+            case EVENT_EXIT:
+                // closing the pidfd takes it out of the epoll set
+                waitid(P_PIDFD, fd, &exit_info, WEXITED | WNOHANG);
+                close(fd);
+                break;
+            }
+        }
+    } while (count == EVENT_BATCH_SIZE);
+
+    if (sweep_exits)
+        while (waitpid(-1, NULL, WNOHANG) > 0)
+            ;
+}
+
+/**
+ * handleSignals - Reads the signals queued to the signalfd and handles them in order
+ *
+ * Description: Standard signals are merged while pending, which is fine for SIGUSR1 as
+ *              every arrival sent so far is received at once. Each process.out queues
+ *              its own COMPLETION_SIGNAL, so none of them is lost.
+ */
+static void handleSignals()
+{
+    struct signalfd_siginfo signals[EVENT_BATCH_SIZE];
+    ssize_t size;
+
+    while ((size = read(signal_fd, signals, sizeof(signals))) > 0)
+    {
+        for (int i = 0; i < size / (ssize_t)sizeof(signals[0]); i++)
+        {
+            int signum = signals[i].ssi_signo;
+            if (signum == SIGUSR1)
+                initializeProcesses(signum);
+            else if (signum == SIGUSR2)
+                noMoreProcesses(signum);
+            else if (signum == SIGINT)
+                interrupted = true;
+            else if (signum == COMPLETION_SIGNAL)
+                completeProcess(signals[i].ssi_int);
+        }
+    }
+}
+
+/**
+ * waitForEvents - Sleeps until the main loop has something to do
+ * @param seen_events: The event counter of the clock read before the loop iteration
+ * @param curr_ticks: The tick the loop iteration has handled
+ *
+ * Description: In real-time mode the loop sleeps on the epoll set, the timerfd is armed
+ *              at the wall time of the next tick. If the clock has not published it yet
+ *              when the timer fires, the wait goes on on the tick futex. Virtual ticks
+ *              have no wall time, so in virtual time the loop sleeps on the event counter
+ *              of the clock, which everyone who signals the scheduler rings as well.
+ */
+static void waitForEvents(uint32_t seen_events, int64_t curr_ticks)
+{
+    struct epoll_event events[EVENT_BATCH_SIZE];
+
+    event_wakeups++;
+    if (isVirtualClk())
+    {
+        waitForClkEvent(seen_events);
+        return;
+    }
+
+    int64_t deadline_ns = shmaddr->epoch_ns + (curr_ticks + 1) * shmaddr->tick_ns;
+    struct itimerspec timer = {.it_value = {deadline_ns / 1000000000LL, deadline_ns % 1000000000LL}};
+    timerfd_settime(tick_fd, TFD_TIMER_ABSTIME, &timer, NULL);
+    epoll_wait(event_fd, events, EVENT_BATCH_SIZE, -1);
+
+    if (getClkTicks() != curr_ticks)
+        recordTickLatency();
+    else if (monotonicNs() >= deadline_ns)
+        waitForTick(curr_ticks);
+}
+
+/**
+ * completeProcess - Finishes the process whose completion was queued from a slot
+ * @param slot: The slot the completion carries
+ *
+ * Description: Each process.out queues COMPLETION_SIGNAL with its slot when it is done,
+ *              and the slot tells which process finished. It may no longer be at the
+ *              front, stopped or sent to the back by its quantum right as it finished;
+ *              then it is marked finished and left in the ready queue until it reaches
+ *              the front. The process.out is reaped once its pidfd says it has exited.
+ */
+static void completeProcess(int slot)
+{
+    PCB *process = slot_processes[slot];
+
+    completions++;
+    reports_handled++;
+    if (process == running_process)
+    {
+        collectReports();
+        if (process == getRunningProcess())
+        {
+            finishRunningProcess();
+            return;
+        }
+        policy->on_preempt(ready_queue, process);
+        running_process = NULL;
+    }
+    process->state = FINISHED;
+    finishProcess(process);
+    late_completions++;
+}
+
+/**
+ * has_pending_work - Checks if any process is still waiting, blocked or running.
+ * @return true if the scheduler needs the clock to keep ticking.
+ */
+static bool has_pending_work()
+{
+    return running_process != NULL || !is_queue_empty(queue) || !is_queue_empty(block_queue) ||
+           policy->size(ready_queue) != 0;
+}
+
+/**
+ * has_pending_arrivals - Checks if the generator has sent arrivals that were not received yet
+ * @return true if the message queue or the arrival ring is not empty
+ */
+static bool has_pending_arrivals()
+{
+    if (transport == ARRIVAL_RING)
+        return arrival_ring_size(arrival_ring) != 0;
+
+    struct msqid_ds arrivals;
+    msgctl(msgget(SHKEY, 0666 | IPC_CREAT), IPC_STAT, &arrivals);
+    return arrivals.msg_qnum != 0;
+}
+
+/**
+ * syncVirtualClk - Acknowledges the current time to the virtual clock once it is fully handled.
+ * @param curr_ticks: The tick the main loop has just handled.
+ *
+ * Description: The time is handled once the generator has sent its arrivals and
+ *              they were forked, every stopped/continued process has acknowledged
+ *              the signal, and the running process has reported the new time unit.
+ *              Virtual processes are run by the main loop before it gets here.
+ *              The next event is the following tick while any process is pending,
+ *              otherwise the scheduler has nothing to wait for.
+ */
+static void syncVirtualClk(int64_t curr_ticks)
+{
+    clk_page_t *page = shmaddr;
+
+    if (curr_ticks == acked_ticks || page->ack[CLK_GENERATOR] < curr_ticks)
+        return;
+    if (page->proc_acks != expected_acks || page->proc_reports != reports_handled)
+        return;
+    if (was_running && !virtual_processes && curr_ticks % CLK_TICKS_PER_UNIT == 0 &&
+        page->proc_reports == reports_base)
+        return;
+
+    // Wait for the arrivals of this time unit to be received and forked
+    if (has_pending_arrivals())
+        return;
+    generateProcesses();
+
+    acked_ticks = curr_ticks;
+    reports_base = page->proc_reports;
+    was_running = running_process != NULL;
+    ackClk(CLK_SCHEDULER, curr_ticks, has_pending_work() ? curr_ticks + 1 : CLK_NO_EVENT);
+}
+
+/**
+ * publishSchedulerStatus - Publishes a snapshot of the scheduler in the clock page
+ * @param curr_ticks: The tick the snapshot is taken at
+ *
+ * Readers such as monitors and tests sample it through readStatus() without
+ * touching the scheduler's queues.
+ */
+static void publishSchedulerStatus(int64_t curr_ticks)
+{
+    clk_status_t status;
+    // the running process stays in the ready structure
+    int ready_count = policy->size(ready_queue);
+
+    status.ticks = curr_ticks;
+    status.running_id = running_process ? running_process->file_id : -1;
+    status.ready_count = ready_count - (running_process != NULL);
+    status.blocked_count = block_queue->size;
+    status.free_mem = free_mem;
+    status.completed = idx;
+    status.wta_sum = total_weighted_turnaround_time;
+    status.wta_sq_sum = total_squared_wta;
+    publishStatus(&status);
+}
+
 /**
  * getSchedulerConfigInstance - Function to get the singleton instance of SchedulerConfig.
  * @return Pointer to the instance.
@@ -607,12 +1217,35 @@ static float calculate_std_wta()
     return sqrt(variance);
 }
 
+static int compare_ints(const void *a, const void *b)
+{
+    return (*(const int *)a > *(const int *)b) - (*(const int *)a < *(const int *)b);
+}
+
+/**
+ * calculate_p99_waiting - Calculates the 99th percentile of the waiting times
+ *
+ * @return The waiting time 99% of the finished processes waited at most, 0 if none finished
+ */
+static int calculate_p99_waiting()
+{
+    if (idx == 0)
+        return 0;
+    qsort(waiting_values, idx, sizeof(int), compare_ints);
+    return waiting_values[(idx * 99 + 99) / 100 - 1];
+}
+
 /**
  * addPerf - Adds performance metrics to a log file
  * @param file: Pointer to the log file
  *
  * This function adds CPU utilization, average WTA, average waiting time, and standard deviation of WTA
- * to a log file.
+ * to a log file, then Jain's fairness index of the share of its turnaround each process ran
+ * for and the 99th percentile of the waiting time, followed by how long the scheduler took
+ * to wake up after each clock tick, how many arrivals each msgrcv brought in and whether any
+ * arrival went missing, how many process.out were spawned and how long they took to get ready,
+ * how long processes took from being received to starting, how many completions were queued, how long a
+ * switching tick took to get the new process continued, and what the main loop cost.
  */
 static void addPerf(FILE *file)
 {
@@ -620,6 +1253,35 @@ static void addPerf(FILE *file)
     fprintf(file, "Avg WTA = %.2f\n", total_weighted_turnaround_time / total_processes);
     fprintf(file, "Avg Waiting = %.2f\n", total_waiting_time / total_processes);
     fprintf(file, "STD WTA = %.2f\n", calculate_std_wta());
+    fprintf(file, "Jain's fairness index = %.4f (runtime / turnaround of %d processes)\n",
+            total_squared_service_rate > 0
+                ? total_service_rate * total_service_rate / (service_rate_count * total_squared_service_rate)
+                : 1.0,
+            service_rate_count);
+    fprintf(file, "Waiting p99 = %d\n", calculate_p99_waiting());
+    fprintf(file, "Tick latency avg = %.2fus max = %.2fus\n",
+            tick_latency.count ? tick_latency.total_ns / 1000.0 / tick_latency.count : 0.0,
+            tick_latency.max_ns / 1000.0);
+    fprintf(file, "Arrivals per syscall = %.2f (%ld arrivals, %ld %s)\n",
+            arrival_syscalls ? (float)arrivals_received / arrival_syscalls : 0.0,
+            arrivals_received, arrival_syscalls, transport == ARRIVAL_RING ? "SIGUSR1" : "msgrcv");
+    fprintf(file, "Arrival gaps = %ld (%ld processes lost)\n", arrival_gaps, lost_arrivals);
+    fprintf(file, "Process launches = %ld spawns, %ld processes run by %d pooled workers\n",
+            process_forks, pooled_jobs, worker_count);
+    fprintf(file, "Spawn latency avg = %.2fus max = %.2fus\n",
+            spawn_latency.count ? spawn_latency.total_ns / 1000.0 / spawn_latency.count : 0.0,
+            spawn_latency.max_ns / 1000.0);
+    fprintf(file, "Arrival to start latency avg = %.2fus max = %.2fus\n",
+            start_latency.count ? start_latency.total_ns / 1000.0 / start_latency.count : 0.0,
+            start_latency.max_ns / 1000.0);
+    fprintf(file, "Completions = %ld (%ld of a process no longer at the front)\n", completions, late_completions);
+    fprintf(file, "Dispatch latency avg = %.2fus max = %.2fus\n",
+            dispatch_latency.count ? dispatch_latency.total_ns / 1000.0 / dispatch_latency.count : 0.0,
+            dispatch_latency.max_ns / 1000.0);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    fprintf(file, "Scheduler wakeups = %ld, CPU time = %.3fs\n", event_wakeups,
+            usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6);
 }
 
 /**
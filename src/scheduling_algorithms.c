@@ -1,95 +1,7 @@
 #include "header.h"
-#include "ds/fib_heap.h"
-#include "ds/queue.h"
 
 //! syntax modification when merging with others for process variable data members
 
-/**
- * decrementCurrentQuantum - Decrement the current quantum value in the scheduler configuration.
- * @param schedulerConfig: Pointer to the scheduler configuration struct.
- */
-void decrementCurrentQuantum(SchedulerConfig *schedulerConfig)
-{
-    schedulerConfig->curr_quantum--;
-}
-/**
- * resetCurrentQuantum - Reset the current quantum value to the initial quantum value in the scheduler configuration.
- * @param schedulerConfig: Pointer to the scheduler configuration struct.
- */
-void resetCurrentQuantum(SchedulerConfig *schedulerConfig)
-{
-    schedulerConfig->curr_quantum = schedulerConfig->quantum;
-}
-
-/**
- * scheduleSRTN - Runs the shortest remaining time first algorithm
- *
- * @param head: Pointer to the ready_queue.
- *
- * Description: Checks if their is a running process and decrease its priority
- *              as it indicates its remaining running time.
- */
-void scheduleRR(void *head)
-{
-    queue_t *queue = (queue_t *)head;
-    PCB *running_process = (PCB *)front(queue);
-    SchedulerConfig *schedulerConfig = getSchedulerConfigInstance();
-
-    // Return if there is no running process
-    if (running_process == NULL)
-        return;
-
-    decrementCurrentQuantum(schedulerConfig);
-    if (schedulerConfig->curr_quantum == 0)
-    {
-        // 1. Push Process To The Back Of The Queue.
-        enqueue(queue, running_process);
-        dequeue(queue);
-        // 2. Reset Quantum.
-        resetCurrentQuantum(schedulerConfig);
-    }
-}
-
-/**
- * scheduleSRTN - Runs the shortest remaining time first algorithm
- *
- * @param head: Pointer to the ready_queue.
- *
- * Description: Checks if their is a running process and decrements its key
- *              as it indicates its remaining running time.
- */
-void scheduleSRTN(void *head)
-{
-    fib_heap_t *heap = (fib_heap_t *) head;
-    heap_node_t *min = heap->min;
-
-    if (min == NULL)
-        return;
-
-    // Decrease The Running Process Runtime.
-    if (min->key > 0)
-        min->key--;
-}
-
-/**
- * scheduleHPF - Schedule a process using the Highest Priority First (HPF) algorithm (non-preemptive).
- * @param head: Pointer to the ready_queue.
- *
- * Description: Checks if their is a running process and decrease its key
- *              as it indicates its priority.
- */
-void scheduleHPF(void *head)
-{
-    fib_heap_t *heap = (fib_heap_t *) head;
-    PCB *running_process = fib_heap_min(heap);
-
-    if (running_process == NULL)
-        return;
-
-    // Decrease The Running Process Key value to make sure it is never replaced.
-    fib_heap_decrease_min_key(heap, 0);
-}
-
 /**
  * addLog - add new log line to the log file
  *
@@ -120,6 +32,7 @@ void addLog(FILE *file, int currentTime, int processId,
  *
  * Description: Stops the old front process and continues the new front process.
  *              If the new front process is -1, it means there's no new front process to switch to.
+ *              Virtual processes are not signalled, the scheduler runs them itself.
  */
 void contentSwitch(PCB *new_front, PCB *old_front, int currentTime, FILE *file)
 {
@@ -139,7 +52,8 @@ void contentSwitch(PCB *new_front, PCB *old_front, int currentTime, FILE *file)
                remaining_time,
                old_front->waiting_time);
         old_front->state = READY;
-        kill(old_front->fork_id, SIGUSR1);
+        if (old_front->fork_id != VIRTUAL_PROCESS)
+            kill(old_front->fork_id, SIGUSR1);
     }
     // started or resumed
 
@@ -171,5 +85,6 @@ void contentSwitch(PCB *new_front, PCB *old_front, int currentTime, FILE *file)
     }
 
     new_front->state = RUNNING;
-    kill(new_front->fork_id, SIGCONT);
+    if (new_front->fork_id != VIRTUAL_PROCESS)
+        kill(new_front->fork_id, SIGCONT);
 }
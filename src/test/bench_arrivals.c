@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "../arrival_ring.h"
+
+// Compares the message queue and the shared memory ring as arrival transports.
+// Like the generator, the producer sends the arrivals of every 1ms slot as batches
+// then kicks the consumer with SIGUSR1, the consumer drains everything on each kick.
+// gcc -O2 src/test/bench_arrivals.c src/arrival_ring.c -o bench_arrivals.out
+// ./bench_arrivals.out [seconds]
+
+#define BENCH_KEY 600
+#define SLOT_NS 1000000LL
+
+static int64_t now_ns()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static double cpu_ms(int who)
+{
+  struct rusage usage;
+  getrusage(who, &usage);
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e3 +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e3;
+}
+
+static void consume(arrival_transport transport, int msgq_id, arrival_ring_t *ring, long total, int64_t epoch)
+{
+  sigset_t kick;
+  msgbuf_t msgbuf;
+  long received = 0, syscalls = 0;
+  double latency_sum = 0, latency_max = 0;
+
+  sigemptyset(&kick);
+  sigaddset(&kick, SIGUSR1);
+  while (received < total)
+  {
+    sigwaitinfo(&kick, NULL);
+    while (1)
+    {
+      if (transport == ARRIVAL_RING)
+        msgbuf.count = arrival_ring_pop(ring, msgbuf.processes, ARRIVAL_BATCH_SIZE);
+      else if (syscalls++, msgrcv(msgq_id, &msgbuf, MSGBUF_SIZE(ARRIVAL_BATCH_SIZE), 0, IPC_NOWAIT) == -1)
+        msgbuf.count = 0;
+      if (msgbuf.count == 0)
+        break;
+
+      double now_us = (now_ns() - epoch) / 1e3;
+      for (int i = 0; i < msgbuf.count; i++)
+      {
+        double latency = now_us - msgbuf.processes[i].arrival;
+        latency_sum += latency;
+        if (latency > latency_max)
+          latency_max = latency;
+      }
+      received += msgbuf.count;
+    }
+  }
+  printf("  consumer: %8.1f ms cpu %9ld syscalls  latency avg %8.1f us max %9.1f us\n",
+         cpu_ms(RUSAGE_SELF), syscalls, latency_sum / total, latency_max);
+}
+
+static void bench(arrival_transport transport, long rate, int seconds)
+{
+  long total = rate * seconds, sent = 0, syscalls = 0, stalls = 0;
+  long per_slot = rate / 1000;
+  int msgq_id = msgget(BENCH_KEY, 0666 | IPC_CREAT);
+  arrival_ring_t *ring = arrival_ring_create(BENCH_KEY, ARRIVAL_RING_CAPACITY);
+  msgbuf_t msgbuf;
+  sigset_t kick;
+
+  sigemptyset(&kick);
+  sigaddset(&kick, SIGUSR1);
+  sigprocmask(SIG_BLOCK, &kick, NULL);
+
+  int64_t epoch = now_ns();
+  pid_t consumer = fork();
+  if (consumer == 0)
+  {
+    consume(transport, msgq_id, ring, total, epoch);
+    exit(0);
+  }
+
+  double cpu_before = cpu_ms(RUSAGE_SELF);
+  for (long slot = 1; sent < total; slot++)
+  {
+    int64_t deadline = epoch + slot * SLOT_NS;
+    struct timespec wake = {deadline / 1000000000LL, deadline % 1000000000LL};
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+
+    long batch_end = sent + per_slot > total ? total : sent + per_slot;
+    int send_us = (now_ns() - epoch) / 1000;
+    while (sent < batch_end)
+    {
+      msgbuf.mytype = 1;
+      msgbuf.count = 0;
+      while (sent + msgbuf.count < batch_end && msgbuf.count < ARRIVAL_BATCH_SIZE)
+      {
+        process_info_t *process = &msgbuf.processes[msgbuf.count++];
+        process->id = sent + msgbuf.count;
+        process->arrival = send_us;
+        process->runtime = process->priority = process->memsize = 1;
+      }
+
+      size_t pushed = 0;
+      while ((int)pushed < msgbuf.count)
+      {
+        if (transport == ARRIVAL_RING)
+          pushed += arrival_ring_push(ring, msgbuf.processes + pushed, msgbuf.count - pushed);
+        else if (syscalls++, msgsnd(msgq_id, &msgbuf, MSGBUF_SIZE(msgbuf.count), IPC_NOWAIT) == 0)
+          pushed = msgbuf.count;
+        if ((int)pushed < msgbuf.count)
+        {
+          stalls++;
+          kill(consumer, SIGUSR1);
+          syscalls++;
+          sched_yield();
+        }
+      }
+      sent += msgbuf.count;
+    }
+    kill(consumer, SIGUSR1);
+    syscalls++;
+  }
+  double producer_cpu = cpu_ms(RUSAGE_SELF) - cpu_before;
+  double elapsed = (now_ns() - epoch) / 1e9;
+
+  while (waitpid(consumer, NULL, 0) == -1 && errno == EINTR)
+    ;
+  printf("%-4s %8ld/s  achieved %10.0f/s  producer: %8.1f ms cpu %9ld syscalls %6ld stalls\n",
+         transport == ARRIVAL_RING ? "ring" : "msgq", rate, total / elapsed, producer_cpu, syscalls, stalls);
+
+  msgctl(msgq_id, IPC_RMID, NULL);
+  arrival_ring_detach(ring);
+  arrival_ring_destroy(BENCH_KEY);
+}
+
+int main(int argc, char *argv[])
+{
+  long rates[] = {1000, 100000, 1000000};
+  int seconds = argc > 1 ? atoi(argv[1]) : 2;
+
+  setvbuf(stdout, NULL, _IONBF, 0);
+  for (int i = 0; i < 3; i++)
+  {
+    bench(ARRIVAL_MSGQ, rates[i], seconds);
+    bench(ARRIVAL_RING, rates[i], seconds);
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <time.h>
+#include "../policy.h"
+
+// Compares the per-tick cost of a policy built into the scheduler with one loaded
+// from a plugin. Every tick the policy picks the process to run, like on a switching
+// tick of the scheduler, then the running process is accounted for: on_tick, or
+// on_finish once it is done and a new process arrives to keep the ready count.
+// Every policy gets the same processes, each is timed best of 3.
+// FCFS is linked in from src/plugins/fcfs.c as well, the same code as fcfs.so.
+// gcc -O2 src/test/bench_policy.c src/policy.c src/policies/*.c src/plugins/fcfs.c src/ds/queue.c src/ds/fib_heap.c src/ds/rb_tree.c -ldl -lm -o bench_policy.out
+// gcc -shared -fPIC -fvisibility=hidden -O2 src/plugins/fcfs.c src/ds/queue.c -o fcfs.so
+// ./bench_policy.out [ticks] [ready processes] [plugin_path]...
+
+#define BENCH_ROUNDS 3
+
+extern const policy_plugin_t policy_plugin;
+
+static int64_t now_ns()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static PCB *new_process(unsigned *seed, int id)
+{
+  PCB *process = calloc(1, sizeof(PCB));
+  process->file_id = id;
+  process->runtime = process->remaining_time = 1 + rand_r(seed) % 30;
+  process->priority = rand_r(seed) % 11;
+  process->state = NEWBIE;
+  process->slot = -1;
+  return process;
+}
+
+static double run(const policy_t *policy, long ticks, int ready_count, long *switches)
+{
+  SchedulerConfig config = {.quantum = 2};
+  unsigned seed = 1;
+  int next_id = 0;
+  PCB *running = NULL;
+
+  void *ready = policy->init(&config);
+  for (int i = 0; i < ready_count; i++)
+    policy->enqueue(ready, new_process(&seed, ++next_id));
+
+  *switches = 0;
+  int64_t start = now_ns();
+  for (long tick = 0; tick < ticks; tick++)
+  {
+    PCB *next = policy->pick_next(ready);
+    if (next != running)
+    {
+      if (running != NULL)
+      {
+        running->state = READY;
+        policy->on_preempt(ready, running);
+      }
+      next->state = RUNNING;
+      running = next;
+      (*switches)++;
+    }
+
+    if (--running->remaining_time > 0)
+      policy->on_tick(ready);
+    else
+    {
+      free(policy->on_finish(ready));
+      running = NULL;
+      policy->enqueue(ready, new_process(&seed, ++next_id));
+    }
+  }
+  double ns_per_tick = (double)(now_ns() - start) / ticks;
+
+  policy->destroy(ready);
+  return ns_per_tick;
+}
+
+static void bench(const char *origin, const policy_t *policy, long ticks, int ready_count)
+{
+  double best = 0;
+  long switches;
+  for (int round = 0; round < BENCH_ROUNDS; round++)
+  {
+    double ns_per_tick = run(policy, ticks, ready_count, &switches);
+    if (round == 0 || ns_per_tick < best)
+      best = ns_per_tick;
+  }
+  printf("  %-5s %-9s %8.1f ns/tick %10ld switches\n", policy->name, origin, best, switches);
+}
+
+int main(int argc, char *argv[])
+{
+  long ticks = argc > 1 ? atol(argv[1]) : 10000000;
+  int ready_count = argc > 2 ? atoi(argv[2]) : 1000;
+
+  printf("%ld ticks, %d ready processes\n", ticks, ready_count);
+  bench("built-in", &hpf_policy, ticks, ready_count);
+  bench("built-in", &srtn_policy, ticks, ready_count);
+  bench("built-in", &rr_policy, ticks, ready_count);
+  bench("built-in", &cfs_policy, ticks, ready_count);
+  bench("built-in", policy_plugin.policy, ticks, ready_count);
+  for (int i = 3; i < argc; i++)
+  {
+    const policy_t *policy = loadPolicy(argv[i]);
+    if (policy != NULL)
+      bench("plugin", policy, ticks, ready_count);
+  }
+  return 0;
+}
@@ -0,0 +1,127 @@
+#include "../ds/rb_tree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#define ASSERT(CONDITION) assert(CONDITION, #CONDITION, __FILE__, __LINE__)
+#define ITEMS 2000
+
+// gcc src/test/test_rb_tree.c src/ds/rb_tree.c -o test_rb_tree.out
+
+typedef struct item_s
+{
+    int key;
+    bool in_tree;
+    rb_node_t node;
+} item_t;
+
+static bool assert(bool cond, char* err_msg, char* file_name, int line)
+{
+    if (!cond)
+        fprintf(stderr,
+                "'%s' is not true in file '%s' at line %d.\n",
+                err_msg,
+                file_name,
+                line);
+
+    return cond;
+}
+
+static int less(const rb_node_t *a, const rb_node_t *b)
+{
+    return rb_entry(a, item_t, node)->key < rb_entry(b, item_t, node)->key;
+}
+
+static bool is_sorted(rb_tree_t *tree)
+{
+    size_t count = 0;
+    int last = -1;
+    for (rb_node_t *node = rb_tree_first(tree); node; node = rb_tree_next(node))
+    {
+        if (rb_entry(node, item_t, node)->key < last)
+            return false;
+        last = rb_entry(node, item_t, node)->key;
+        count++;
+    }
+    return count == tree->size;
+}
+
+static void test_tree_correctness()
+{
+    static item_t items[ITEMS];
+    rb_tree_t tree;
+    size_t i;
+
+    rb_tree_init(&tree);
+    ASSERT(rb_tree_first(&tree) == NULL);
+    ASSERT(rb_tree_is_healthy(&tree, less));
+
+    // Ascending, descending and equal keys
+    for (i = 0; i < 30; ++i)
+    {
+        items[i].key = i;
+        rb_tree_insert(&tree, &items[i].node, less);
+    }
+    for (i = 30; i < 60; ++i)
+    {
+        items[i].key = 90 - i;
+        rb_tree_insert(&tree, &items[i].node, less);
+    }
+    for (i = 60; i < 70; ++i)
+    {
+        items[i].key = 7;
+        rb_tree_insert(&tree, &items[i].node, less);
+    }
+    ASSERT(tree.size == 70);
+    ASSERT(rb_tree_is_healthy(&tree, less));
+    ASSERT(is_sorted(&tree));
+
+    // Equal keys come out in the order they went in
+    rb_node_t *node = rb_tree_first(&tree);
+    while (rb_entry(node, item_t, node)->key != 7)
+        node = rb_tree_next(node);
+    ASSERT(node == &items[7].node);
+    for (i = 60; i < 70; ++i)
+    {
+        node = rb_tree_next(node);
+        ASSERT(node == &items[i].node);
+    }
+
+    while (rb_tree_first(&tree))
+    {
+        int key = rb_entry(rb_tree_first(&tree), item_t, node)->key;
+        rb_tree_erase(&tree, rb_tree_first(&tree));
+        ASSERT(rb_tree_first(&tree) == NULL || rb_entry(rb_tree_first(&tree), item_t, node)->key >= key);
+    }
+    ASSERT(tree.size == 0);
+    ASSERT(rb_tree_is_healthy(&tree, less));
+
+    // Random inserts and erases anywhere in the tree
+    srand(1);
+    for (i = 0; i < ITEMS; ++i)
+        items[i].in_tree = false;
+    for (i = 0; i < 50 * ITEMS; ++i)
+    {
+        item_t *item = &items[rand() % ITEMS];
+        if (item->in_tree)
+            rb_tree_erase(&tree, &item->node);
+        else
+        {
+            item->key = rand() % 500;
+            rb_tree_insert(&tree, &item->node, less);
+        }
+        item->in_tree = !item->in_tree;
+        if (i % 997 == 0)
+        {
+            ASSERT(rb_tree_is_healthy(&tree, less));
+            ASSERT(is_sorted(&tree));
+        }
+    }
+    ASSERT(rb_tree_is_healthy(&tree, less));
+    ASSERT(is_sorted(&tree));
+}
+
+int main() {
+  test_tree_correctness();
+  printf("SUCCESS");
+  return 0;
+}
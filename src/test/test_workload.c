@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <sys/resource.h>
+#include "../workload.h"
+
+// gcc src/test/test_workload.c src/workload.c -pthread -o test_workload.out
+// ./test_workload.out processes.txt
+// ./test_workload.out -s processes.txt...   streams the files, merged by arrival, and reports the peak RSS
+static void print_process(const process_info_t *process)
+{
+    printf("(%d, %d, %d, %d, %d)\n", process->id, process->arrival, process->runtime,
+           process->priority, process->memsize);
+}
+
+static int stream(char *const file_paths[], int file_count)
+{
+    workload_merge_t merge;
+    if (open_workload_merge(&merge, file_paths, file_count, WORKLOAD_STREAM_WINDOW) == -1)
+        return 1;
+
+    size_t count = 0;
+    int last_arrival = 0;
+    bool sorted = true;
+    process_info_t *process;
+    while ((process = peek_workload_merge(&merge)) != NULL)
+    {
+        if (count < 5)
+            print_process(process);
+        sorted = sorted && process->arrival >= last_arrival;
+        last_arrival = process->arrival;
+        count++;
+        pop_workload_merge(&merge);
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    size_t bytes = 0;
+    double parse_seconds = 0;
+    bool error = false;
+    for (size_t i = 0; i < merge.stream_count; i++)
+    {
+        bytes += merge.streams[i].bytes;
+        parse_seconds = merge.streams[i].parse_seconds > parse_seconds ? merge.streams[i].parse_seconds : parse_seconds;
+        error = error || merge.streams[i].error;
+    }
+    printf("count: %zu%s%s\n", count, sorted ? "" : ", not sorted by arrival", error ? ", stopped at an error" : "");
+    printf("%.2f MB in %.3f s, peak RSS %.2f MB\n", bytes / (1024.0 * 1024.0), parse_seconds, usage.ru_maxrss / 1024.0);
+    close_workload_merge(&merge);
+    return error ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 3 && strcmp(argv[1], "-s") == 0)
+        return stream(argv + 2, argc - 2);
+    if (argc != 2)
+    {
+        printf("Use: ./test_workload.out <processes_file>\n");
+        printf("     ./test_workload.out -s <processes_file>...\n");
+        return 1;
+    }
+
+    workload_t workload;
+    if (load_workload(&workload, argv[1]) == -1)
+        return 1;
+
+    printf("count: %zu\n", workload.count);
+    for (size_t i = 0; i < workload.count && i < 5; i++)
+        print_process(&workload.processes[i]);
+    printf("%.2f MB in %.3f s\n", workload.bytes / (1024.0 * 1024.0), workload.parse_seconds);
+
+    free_workload(&workload);
+    return 0;
+}
@@ -1,8 +1,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <limits.h>
+#include <pthread.h>
 #include "header.h"
-#define null 0
+#include "distributions.h"
+
+#define MAX_RUNTIME 1000000 /* heavy tails are cut here so a run still ends */
+#define MAX_MEMSIZE 256     /* memsize is at most 256 bytes */
+#define CONFIG_LINE_SIZE 256
+#define CHUNK_PROCESSES (1 << 16) /* processes drawn from one random stream */
+#define MAX_LINE_SIZE 64          /* five integers, their tabs and the newline */
 
 struct processData
 {
@@ -13,30 +21,424 @@ struct processData
     int memsize;
 };
 
-int main(int argc, char *argv[])
+/**
+ * struct generator_config_s - Everything a workload is generated from
+ * @count: number of processes
+ * @seed: seed of the generator, the same config and seed give the same file
+ * @arrival: gaps between consecutive arrivals in time units
+ * @runtime: running time of a process
+ * @priority: priority of a process
+ * @memsize: memory size of a process
+ */
+typedef struct generator_config_s
+{
+    long count;
+    uint64_t seed;
+    distribution_t arrival;
+    distribution_t runtime;
+    distribution_t priority;
+    distribution_t memsize;
+} generator_config_t;
+
+/**
+ * struct generation_s - State shared by the threads writing a workload
+ * @config: what to generate
+ * @file: the output file
+ * @streams: the random stream of every chunk, chunk k uses the seed's stream jumped k times
+ * @chunk_count: number of chunks
+ * @next_chunk: next chunk to be taken by a thread
+ * @based_chunks: chunks whose first arrival is known, they are based in order
+ * @next_base: time units from the first arrival to the start of chunk @based_chunks
+ * @written_chunks: chunks written so far, they are written in order
+ * @overflowed: the arrival times overflowed, nothing more is written
+ * @written: processes written
+ * @last_arrival: arrival of the last process written
+ * @runtime_sum: sum of the runtimes written
+ * @memsize_sum: sum of the memory sizes written
+ * @runtime_max: largest runtime written
+ * @lock: guards everything above that changes
+ * @turn: broadcast when @based_chunks or @written_chunks moves
+ *
+ * Description: A chunk is drawn, based, formatted and written by the same thread,
+ *              only basing and writing wait for the chunks before it. The output
+ *              depends on the seed alone, not on the number of threads.
+ */
+typedef struct generation_s
 {
-    FILE *pFile;
+    generator_config_t *config;
+    FILE *file;
+    rng_t *streams;
+    long chunk_count;
+    long next_chunk;
+    long based_chunks;
+    double next_base;
+    long written_chunks;
+    bool overflowed;
+    long written;
+    int last_arrival;
+    double runtime_sum;
+    double memsize_sum;
+    int runtime_max;
+    pthread_mutex_t lock;
+    pthread_cond_t turn;
+} generation_t;
+
+void *generate_chunks(void *arg);
+char *write_int(char *out, int value);
+void usage();
+int set_option(generator_config_t *config, char option, const char *value);
+int read_config(generator_config_t *config, const char *file_path);
+int clamp(double value, int min, int max);
+
+/**
+ * main - writes a synthetic processes file
+ *
+ * Description: Nothing is asked interactively, the workload comes from the flags
+ *              and an optional config file holding one "option value" pair per line
+ *              (count, seed, arrival, runtime, priority, memsize). Later flags override
+ *              earlier ones. Without any flag the file looks like the original generator's:
+ *              100 processes with uniform gaps, runtimes, priorities and memory sizes.
+ */
+int main(int argc, char *argv[]) // [-n count] [-s seed] [-a dist] [-r dist] [-p dist] [-m dist] [-f config] [-j threads] [output_file]
+{
+    generator_config_t config = {.count = 100, .seed = time(NULL)};
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    parse_distribution(&config.arrival, "uniform:0,10");
+    parse_distribution(&config.runtime, "uniform:0,29");
+    parse_distribution(&config.priority, "uniform:0,10");
+    parse_distribution(&config.memsize, "uniform:0,256");
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:a:r:p:m:f:j:")) != -1)
+    {
+        int result;
+        if (opt == 'j')
+            result = (threads = atol(optarg)) > 0 ? 0 : -1;
+        else
+            result = opt == 'f' ? read_config(&config, optarg) : set_option(&config, opt, optarg);
+        if (result == -1)
+        {
+            usage();
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (argc - optind > 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
     char file_path[PATH_SIZE];
-    getAbsolutePath(file_path, "processes.txt");
-    pFile = fopen(file_path, "w");
-    int no;
-    struct processData pData;
-    printf("Please enter the number of processes you want to generate: ");
-    scanf("%d", &no);
-    srand(time(null));
-    // fprintf(pFile,"%d\n",no);
-    fprintf(pFile, "#id arrival runtime priority\n");
-    pData.arrival_time = 1;
-    for (int i = 1; i <= no; i++)
-    {
-        // generate Data Randomly
-        //[min-max] = rand() % (max_number + 1 - minimum_number) + minimum_number
-        pData.id = i;
-        pData.arrival_time += rand() % (11); // processes arrives in order
-        pData.running_time = rand() % (30);
-        pData.priority = rand() % (11);
-        pData.memsize = rand() % (257); // memsize is at most 256 bytes
-        fprintf(pFile, "%d\t%d\t%d\t%d\t%d\n", pData.id, pData.arrival_time, pData.running_time, pData.priority, pData.memsize);
+    if (optind < argc)
+        snprintf(file_path, PATH_SIZE, "%s", argv[optind]);
+    else
+        getAbsolutePath(file_path, "processes.txt");
+    FILE *pFile = fopen(file_path, "w");
+    if (pFile == NULL)
+    {
+        printf("\nCould not create file %s!!\n", file_path);
+        exit(EXIT_FAILURE);
     }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    generation_t generation = {.config = &config, .file = pFile};
+    generation.chunk_count = (config.count + CHUNK_PROCESSES - 1) / CHUNK_PROCESSES;
+    generation.streams = malloc(sizeof(rng_t) * (generation.chunk_count + 1));
+    if (generation.streams == NULL)
+    {
+        perror("Could not allocate the random streams");
+        exit(EXIT_FAILURE);
+    }
+    rng_seed(&generation.streams[0], config.seed);
+    for (long k = 1; k < generation.chunk_count; k++)
+    {
+        generation.streams[k] = generation.streams[k - 1];
+        rng_jump(&generation.streams[k]);
+    }
+    pthread_mutex_init(&generation.lock, NULL);
+    pthread_cond_init(&generation.turn, NULL);
+
+    fprintf(pFile, "#id arrival runtime priority memsize\n");
+    if (threads > generation.chunk_count)
+        threads = generation.chunk_count > 0 ? generation.chunk_count : 1;
+    pthread_t workers[threads];
+    for (long t = 1; t < threads; t++)
+        pthread_create(&workers[t], NULL, generate_chunks, &generation);
+    generate_chunks(&generation);
+    for (long t = 1; t < threads; t++)
+        pthread_join(workers[t], NULL);
     fclose(pFile);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    if (generation.overflowed)
+        printf("Arrival times overflow after %ld processes\n", generation.written);
+    config.count = generation.written;
+    char arrival[64], runtime[64], priority[64], memsize[64];
+    describe_distribution(&config.arrival, arrival, sizeof(arrival));
+    describe_distribution(&config.runtime, runtime, sizeof(runtime));
+    describe_distribution(&config.priority, priority, sizeof(priority));
+    describe_distribution(&config.memsize, memsize, sizeof(memsize));
+    printf("Wrote %ld processes to %s in %.3f s with %ld threads, %.2f M processes/s\n", config.count, file_path,
+           seconds, threads, seconds > 0 ? config.count / seconds / 1e6 : 0.0);
+    printf("Seed %llu, arrival %s, runtime %s, priority %s, memsize %s\n", (unsigned long long)config.seed,
+           arrival, runtime, priority, memsize);
+    printf("Last arrival %d, runtime avg %.2f max %d, memsize avg %.2f\n", generation.last_arrival,
+           config.count ? generation.runtime_sum / config.count : 0.0, generation.runtime_max,
+           config.count ? generation.memsize_sum / config.count : 0.0);
+
+    pthread_mutex_destroy(&generation.lock);
+    pthread_cond_destroy(&generation.turn);
+    free(generation.streams);
+
+    free_distribution(&config.arrival);
+    free_distribution(&config.runtime);
+    free_distribution(&config.priority);
+    free_distribution(&config.memsize);
+    return 0;
+}
+
+/**
+ * generate_chunks - body of the threads, draws and writes chunks until none is left
+ * @arg: the generation_t
+ *
+ * Description: The arrival times of a chunk are drawn relative to its start, which is
+ *              only known once the chunk before it is drawn. Everything else is drawn
+ *              and formatted without waiting for the other chunks.
+ */
+void *generate_chunks(void *arg)
+{
+    generation_t *generation = arg;
+    generator_config_t *config = generation->config;
+    struct processData *chunk = malloc(sizeof(struct processData) * CHUNK_PROCESSES);
+    double *offsets = malloc(sizeof(double) * CHUNK_PROCESSES);
+    char *buffer = malloc((size_t)MAX_LINE_SIZE * CHUNK_PROCESSES);
+
+    if (chunk == NULL || offsets == NULL || buffer == NULL)
+    {
+        perror("Could not allocate a chunk");
+        exit(EXIT_FAILURE);
+    }
+    while (1)
+    {
+        pthread_mutex_lock(&generation->lock);
+        long k = generation->next_chunk++;
+        pthread_mutex_unlock(&generation->lock);
+        if (k >= generation->chunk_count)
+            break;
+
+        // every chunk starts from the configured state of the distributions
+        rng_t rng = generation->streams[k];
+        distribution_t arrival = config->arrival, runtime = config->runtime;
+        distribution_t priority = config->priority, memsize = config->memsize;
+        long first_id = k * CHUNK_PROCESSES + 1;
+        int count = config->count - k * CHUNK_PROCESSES < CHUNK_PROCESSES ? config->count - k * CHUNK_PROCESSES : CHUNK_PROCESSES;
+        double offset = 0;
+        for (int i = 0; i < count; i++)
+        {
+            offsets[i] = offset += sample_distribution(&arrival, &rng);
+            chunk[i].running_time = clamp(sample_distribution(&runtime, &rng), 0, MAX_RUNTIME);
+            chunk[i].priority = clamp(sample_distribution(&priority, &rng), 0, INT_MAX);
+            chunk[i].memsize = clamp(sample_distribution(&memsize, &rng), 0, MAX_MEMSIZE);
+        }
+
+        pthread_mutex_lock(&generation->lock);
+        while (generation->based_chunks != k)
+            pthread_cond_wait(&generation->turn, &generation->lock);
+        double base = generation->next_base;
+        generation->next_base += offset;
+        generation->based_chunks++;
+        pthread_cond_broadcast(&generation->turn);
+        pthread_mutex_unlock(&generation->lock);
+
+        // processes arrive in order, the fractions of a time unit add up between them
+        char *out = buffer;
+        int formatted = 0;
+        double runtime_sum = 0, memsize_sum = 0;
+        int runtime_max = 0;
+        for (; formatted < count; formatted++)
+        {
+            double arrival_time = 1 + (base + offsets[formatted]);
+            if (arrival_time > INT_MAX)
+                break;
+            chunk[formatted].id = first_id + formatted;
+            chunk[formatted].arrival_time = arrival_time;
+
+            struct processData *pData = &chunk[formatted];
+            out = write_int(out, pData->id);
+            *out++ = '\t';
+            out = write_int(out, pData->arrival_time);
+            *out++ = '\t';
+            out = write_int(out, pData->running_time);
+            *out++ = '\t';
+            out = write_int(out, pData->priority);
+            *out++ = '\t';
+            out = write_int(out, pData->memsize);
+            *out++ = '\n';
+
+            runtime_sum += pData->running_time;
+            memsize_sum += pData->memsize;
+            if (pData->running_time > runtime_max)
+                runtime_max = pData->running_time;
+        }
+
+        pthread_mutex_lock(&generation->lock);
+        while (generation->written_chunks != k)
+            pthread_cond_wait(&generation->turn, &generation->lock);
+        if (!generation->overflowed && formatted > 0)
+        {
+            fwrite(buffer, 1, out - buffer, generation->file);
+            generation->written += formatted;
+            generation->last_arrival = chunk[formatted - 1].arrival_time;
+            generation->runtime_sum += runtime_sum;
+            generation->memsize_sum += memsize_sum;
+            if (runtime_max > generation->runtime_max)
+                generation->runtime_max = runtime_max;
+        }
+        generation->overflowed = generation->overflowed || formatted < count;
+        generation->written_chunks++;
+        pthread_cond_broadcast(&generation->turn);
+        pthread_mutex_unlock(&generation->lock);
+    }
+
+    free(chunk);
+    free(offsets);
+    free(buffer);
+    return NULL;
+}
+
+/**
+ * write_int - writes a non-negative integer in decimal, faster than fprintf
+ * @out: where to write it
+ * @value: the integer
+ *
+ * Return: the end of the written digits
+ */
+char *write_int(char *out, int value)
+{
+    char digits[10];
+    int length = 0;
+
+    do
+    {
+        digits[length++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+    while (length > 0)
+        *out++ = digits[--length];
+    return out;
+}
+
+void usage()
+{
+    printf("Use: ./test_generator [-n count] [-s seed] [-a dist] [-r dist] [-p dist] [-m dist] [-f config] [-j threads] [output_file]\n");
+    printf("  -a: gaps between arrivals, uniform:min,max | poisson:rate | mmpp:quiet_rate,burst_rate,quiet_length,burst_length\n");
+    printf("  -r, -p, -m: runtime, priority and memsize, uniform:min,max | exp:mean | pareto:alpha,min\n");
+    printf("              | bimodal:short_mean,long_mean,long_probability | zipf:s,n | lognormal:mu,sigma\n");
+    printf("  -f: file of \"option value\" lines, the options being count, seed, arrival, runtime, priority and memsize\n");
+    printf("  -j: number of threads, all cores by default, the output does not depend on it\n");
+}
+
+/**
+ * set_option - applies one option to the config
+ * @config: the config
+ * @option: the flag of the option
+ * @value: its value
+ *
+ * Return: 0 on success, -1 if the option or its value is invalid
+ */
+int set_option(generator_config_t *config, char option, const char *value)
+{
+    distribution_t *dist = NULL;
+    char *end;
+
+    switch (option)
+    {
+    case 'n':
+        config->count = strtol(value, &end, 10);
+        return *end == '\0' && config->count >= 0 ? 0 : -1;
+    case 's':
+        config->seed = strtoull(value, &end, 10);
+        return *end == '\0' ? 0 : -1;
+    case 'a':
+        dist = &config->arrival;
+        break;
+    case 'r':
+        dist = &config->runtime;
+        break;
+    case 'p':
+        dist = &config->priority;
+        break;
+    case 'm':
+        dist = &config->memsize;
+        break;
+    default:
+        return -1;
+    }
+
+    distribution_t parsed;
+    if (parse_distribution(&parsed, value) == -1)
+    {
+        printf("Invalid distribution %s\n", value);
+        free_distribution(&parsed);
+        return -1;
+    }
+    free_distribution(dist);
+    *dist = parsed;
+    return 0;
+}
+
+/**
+ * read_config - applies the options of a config file
+ * @config: the config
+ * @file_path: path of the file, '#' starts a comment line
+ *
+ * Return: 0 on success, -1 if the file can not be read or holds an invalid option
+ */
+int read_config(generator_config_t *config, const char *file_path)
+{
+    static const char *names[] = {"count", "seed", "arrival", "runtime", "priority", "memsize"};
+    static const char flags[] = {'n', 's', 'a', 'r', 'p', 'm'};
+    char line[CONFIG_LINE_SIZE], name[CONFIG_LINE_SIZE], value[CONFIG_LINE_SIZE];
+    int line_number = 0;
+
+    FILE *file = fopen(file_path, "r");
+    if (file == NULL)
+    {
+        printf("\nCould not open file %s!!\n", file_path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        line_number++;
+        int fields = sscanf(line, "%s %s", name, value);
+        if (fields <= 0 || name[0] == '#')
+            continue;
+
+        char flag = 0;
+        for (int i = 0; i < 6; i++)
+            if (strcmp(name, names[i]) == 0)
+                flag = flags[i];
+        if (fields != 2 || flag == 0 || set_option(config, flag, value) == -1)
+        {
+            printf("Invalid option on line %d of %s\n", line_number, file_path);
+            fclose(file);
+            return -1;
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+/**
+ * clamp - rounds a drawn value to the nearest integer within [min, max]
+ */
+int clamp(double value, int min, int max)
+{
+    if (!(value >= min)) // NaN as well
+        return min;
+    if (value >= max)
+        return max;
+    return (int)(value + 0.5);
 }
@@ -0,0 +1,766 @@
+#define _GNU_SOURCE /* memrchr */
+#include "workload.h"
+#include <endian.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <limits.h>
+
+#define WORKLOAD_COLUMNS 5
+#define WORKLOAD_FIELDS (sizeof(process_info_t) / sizeof(int32_t))
+#define FNV_PRIME 1099511628211ULL
+#define STREAM_CHUNK_BYTES (1 << 20) /* bytes read() at once by the stream reader */
+#define STREAM_BATCH 4096            /* records the stream reader parses before publishing them */
+#define MERGE_MIN_WINDOW 4096        /* smallest window of one merged stream */
+
+static double elapsed_seconds(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Reads one integer starting at *cursor, skipping the blanks before it.
+ * Returns false if the line ends before a number is found.
+ */
+static bool scan_int(const char **cursor, const char *end, int *value)
+{
+    const char *p = *cursor;
+    bool negative = false;
+    long number = 0;
+
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+    if (p == end || *p < '0' || *p > '9')
+        return false;
+    while (p < end && *p >= '0' && *p <= '9')
+        number = number * 10 + (*p++ - '0');
+
+    *value = negative ? -number : number;
+    *cursor = p;
+    return true;
+}
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+/*
+ * Swaps the fields of records between little-endian and the host order.
+ */
+static void swap_records(process_info_t *processes, size_t count)
+{
+    int32_t *fields = (int32_t *)processes;
+    for (size_t i = 0; i < count * WORKLOAD_FIELDS; i++)
+        fields[i] = le32toh(fields[i]);
+}
+#endif
+
+/*
+ * Parses the line [line, line_end) into a process.
+ * Returns 1 if it holds a process, 0 for a comment or blank line and -1 if it is malformed.
+ */
+static int parse_line(const char *line, const char *line_end, process_info_t *process)
+{
+    const char *cursor = line;
+    int fields[WORKLOAD_COLUMNS];
+
+    while (cursor < line_end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r'))
+        cursor++;
+    if (cursor == line_end || *line == '#')
+        return 0;
+
+    for (int i = 0; i < WORKLOAD_COLUMNS; i++)
+        if (!scan_int(&cursor, line_end, &fields[i]))
+            return -1;
+    process->id = fields[0];
+    process->arrival = fields[1];
+    process->runtime = fields[2];
+    process->priority = fields[3];
+    process->memsize = fields[4];
+    return 1;
+}
+
+static int parse_text(workload_t *workload, const char *data, const char *file_path)
+{
+    size_t line_number = 0;
+
+    // every record takes a line, so the line count bounds the array
+    const char *end = data + workload->bytes;
+    size_t lines = 1;
+    for (const char *p = data; (p = memchr(p, '\n', end - p)) != NULL; p++)
+        lines++;
+    workload->processes = malloc(sizeof(process_info_t) * lines);
+    if (workload->processes == NULL)
+    {
+        perror("Could not allocate the processes array");
+        return -1;
+    }
+
+    const char *line = data;
+    while (line < end)
+    {
+        const char *line_end = memchr(line, '\n', end - line);
+        if (line_end == NULL)
+            line_end = end;
+        line_number++;
+
+        int parsed = parse_line(line, line_end, &workload->processes[workload->count]);
+        if (parsed == -1)
+        {
+            printf("\nMalformed line %zu in %s, expected %d integers\n", line_number, file_path, WORKLOAD_COLUMNS);
+            free_workload(workload);
+            return -1;
+        }
+        workload->count += parsed;
+        line = line_end + 1;
+    }
+    return 0;
+}
+
+/*
+ * Checks the header of a binary workload holding count records in a file of the given size.
+ */
+static bool valid_header(const workload_header_t *header, size_t file_bytes)
+{
+    uint64_t count = le64toh(header->count);
+    return le32toh(header->version) == WORKLOAD_VERSION && le32toh(header->record_size) == sizeof(process_info_t) &&
+           count <= (file_bytes - sizeof(workload_header_t)) / sizeof(process_info_t) &&
+           sizeof(workload_header_t) + count * sizeof(process_info_t) == file_bytes;
+}
+
+static int load_binary(workload_t *workload, void *data, const char *file_path)
+{
+    const workload_header_t *header = data;
+    uint64_t count = le64toh(header->count);
+
+    if (!valid_header(header, workload->bytes))
+    {
+        printf("\nCorrupted binary workload %s\n", file_path);
+        return -1;
+    }
+
+    workload->format = WORKLOAD_BINARY;
+    workload->count = count;
+    workload->checksum = le64toh(header->checksum);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    workload->processes = (process_info_t *)((char *)data + sizeof(workload_header_t));
+    workload->mapping = data;
+#else
+    workload->processes = malloc(sizeof(process_info_t) * count);
+    if (workload->processes == NULL)
+    {
+        perror("Could not allocate the processes array");
+        return -1;
+    }
+    memcpy(workload->processes, (char *)data + sizeof(workload_header_t), sizeof(process_info_t) * count);
+    swap_records(workload->processes, count);
+#endif
+    return 0;
+}
+
+int load_workload(workload_t *workload, const char *file_path)
+{
+    struct timespec start;
+    struct stat file_stat;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    workload->processes = NULL;
+    workload->count = 0;
+    workload->bytes = 0;
+    workload->parse_seconds = 0;
+    workload->format = WORKLOAD_TEXT;
+    workload->checksum = 0;
+    workload->mapping = NULL;
+
+    int fd = open(file_path, O_RDONLY);
+    if (fd == -1 || fstat(fd, &file_stat) == -1)
+    {
+        printf("\nCould not open file %s!!\n", file_path);
+        if (fd != -1)
+            close(fd);
+        return -1;
+    }
+    workload->bytes = file_stat.st_size;
+    if (workload->bytes == 0)
+    {
+        close(fd);
+        return 0;
+    }
+
+    char *data = mmap(NULL, workload->bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        perror("Could not map the processes file");
+        return -1;
+    }
+    madvise(data, workload->bytes, MADV_SEQUENTIAL);
+
+    int result;
+    if (workload->bytes >= sizeof(workload_header_t) && memcmp(data, WORKLOAD_MAGIC, 8) == 0)
+        result = load_binary(workload, data, file_path);
+    else
+        result = parse_text(workload, data, file_path);
+
+    // a binary workload used in place keeps its mapping until free_workload()
+    if (workload->mapping != data)
+        munmap(data, workload->bytes);
+    workload->parse_seconds = elapsed_seconds(&start);
+    return result;
+}
+
+uint64_t workload_checksum_update(uint64_t hash, const process_info_t *processes, size_t count)
+{
+    const int32_t *fields = (const int32_t *)processes;
+
+    for (size_t i = 0; i < count * WORKLOAD_FIELDS; i++)
+    {
+        uint32_t field = htole32(fields[i]);
+        const unsigned char *bytes = (const unsigned char *)&field;
+        for (int j = 0; j < 4; j++)
+            hash = (hash ^ bytes[j]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t workload_checksum(const process_info_t *processes, size_t count)
+{
+    return workload_checksum_update(WORKLOAD_CHECKSUM_INIT, processes, count);
+}
+
+int verify_workload(const workload_t *workload)
+{
+    if (workload->format != WORKLOAD_BINARY)
+        return 0;
+    return workload_checksum(workload->processes, workload->count) == workload->checksum ? 0 : -1;
+}
+
+int open_workload_writer(workload_writer_t *writer, const char *file_path, workload_format format)
+{
+    memset(writer, 0, sizeof(*writer));
+    writer->file_path = file_path;
+    writer->format = format;
+    writer->checksum = WORKLOAD_CHECKSUM_INIT;
+    writer->file = fopen(file_path, "w");
+    if (writer->file == NULL)
+    {
+        printf("\nCould not create file %s!!\n", file_path);
+        return -1;
+    }
+
+    // the header of a binary file is rewritten once the records are known
+    workload_header_t header;
+    memset(&header, 0, sizeof(header));
+    bool written = format == WORKLOAD_BINARY ? fwrite(&header, sizeof(header), 1, writer->file) == 1
+                                             : fputs(WORKLOAD_TEXT_HEADER, writer->file) >= 0;
+    if (!written)
+    {
+        printf("\nCould not write file %s!!\n", file_path);
+        fclose(writer->file);
+        return -1;
+    }
+    return 0;
+}
+
+int write_workload_records(workload_writer_t *writer, const process_info_t *processes, size_t count)
+{
+    if (count == 0)
+        return 0;
+    if (writer->count == 0)
+        writer->first_arrival = processes[0].arrival;
+    writer->last_arrival = processes[count - 1].arrival;
+    writer->count += count;
+    writer->checksum = workload_checksum_update(writer->checksum, processes, count);
+
+    if (writer->format == WORKLOAD_TEXT)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            const process_info_t *process = &processes[i];
+            if (fprintf(writer->file, "%d\t%d\t%d\t%d\t%d\n", process->id, process->arrival, process->runtime,
+                        process->priority, process->memsize) < 0)
+                return -1;
+        }
+        return 0;
+    }
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return fwrite(processes, sizeof(process_info_t), count, writer->file) == count ? 0 : -1;
+#else
+    for (size_t i = 0; i < count; i++)
+    {
+        process_info_t record = processes[i];
+        swap_records(&record, 1);
+        if (fwrite(&record, sizeof(record), 1, writer->file) != 1)
+            return -1;
+    }
+    return 0;
+#endif
+}
+
+int close_workload_writer(workload_writer_t *writer)
+{
+    int result = 0;
+
+    if (writer->format == WORKLOAD_BINARY)
+    {
+        workload_header_t header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, WORKLOAD_MAGIC, 8);
+        header.version = htole32(WORKLOAD_VERSION);
+        header.record_size = htole32(sizeof(process_info_t));
+        header.count = htole64(writer->count);
+        header.first_arrival = htole32(writer->first_arrival);
+        header.last_arrival = htole32(writer->last_arrival);
+        header.checksum = htole64(writer->checksum);
+        if (fseek(writer->file, 0, SEEK_SET) == -1 || fwrite(&header, sizeof(header), 1, writer->file) != 1)
+            result = -1;
+    }
+    if (fclose(writer->file) != 0 || result == -1)
+    {
+        printf("\nCould not write file %s!!\n", writer->file_path);
+        return -1;
+    }
+    return 0;
+}
+
+int save_workload(const workload_t *workload, const char *file_path, workload_format format)
+{
+    workload_writer_t writer;
+    if (open_workload_writer(&writer, file_path, format) == -1)
+        return -1;
+
+    if (write_workload_records(&writer, workload->processes, workload->count) == -1)
+    {
+        fclose(writer.file);
+        printf("\nCould not write file %s!!\n", file_path);
+        return -1;
+    }
+    return close_workload_writer(&writer);
+}
+
+void free_workload(workload_t *workload)
+{
+    if (workload->mapping != NULL)
+        munmap(workload->mapping, workload->bytes);
+    else
+        free(workload->processes);
+    workload->processes = NULL;
+    workload->mapping = NULL;
+    workload->count = 0;
+}
+
+/*
+ * Reads up to size bytes, retrying short reads. Returns the bytes read or -1 on error.
+ */
+static ssize_t read_fully(int fd, void *buffer, size_t size)
+{
+    size_t done = 0;
+    while (done < size)
+    {
+        ssize_t got = read(fd, (char *)buffer + done, size - done);
+        if (got == -1 && errno == EINTR)
+            continue;
+        if (got == -1)
+            return -1;
+        if (got == 0)
+            break;
+        done += got;
+    }
+    return done;
+}
+
+/*
+ * Copies records into the window, waiting for the consumer to make room.
+ * Returns false if the stream is being closed.
+ */
+static bool publish_records(workload_stream_t *stream, const process_info_t *records, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        stream->unsorted += records[i].arrival < stream->last_arrival;
+        stream->last_arrival = records[i].arrival;
+    }
+
+    while (count > 0)
+    {
+        pthread_mutex_lock(&stream->lock);
+        while (!stream->closing && stream->tail - __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE) == stream->capacity)
+            pthread_cond_wait(&stream->not_full, &stream->lock);
+        if (stream->closing)
+        {
+            pthread_mutex_unlock(&stream->lock);
+            return false;
+        }
+
+        size_t room = stream->capacity - (stream->tail - stream->head);
+        size_t batch = count < room ? count : room;
+        for (size_t i = 0; i < batch; i++)
+            stream->window[(stream->tail + i) & (stream->capacity - 1)] = records[i];
+        __atomic_store_n(&stream->tail, stream->tail + batch, __ATOMIC_RELEASE);
+        stream->count += batch;
+        pthread_cond_signal(&stream->not_empty);
+        pthread_mutex_unlock(&stream->lock);
+
+        records += batch;
+        count -= batch;
+    }
+    return true;
+}
+
+static int stream_text(workload_stream_t *stream, process_info_t *batch)
+{
+    char *buffer = malloc(STREAM_CHUNK_BYTES);
+    size_t carried = 0, line_number = 0, batched = 0;
+    bool eof = false;
+    int result = 0;
+
+    if (buffer == NULL)
+    {
+        perror("Could not allocate the stream buffer");
+        return -1;
+    }
+    while (!eof && result == 0)
+    {
+        ssize_t got = read_fully(stream->fd, buffer + carried, STREAM_CHUNK_BYTES - carried);
+        if (got == -1)
+        {
+            perror("Could not read the processes file");
+            result = -1;
+            break;
+        }
+        stream->bytes += got;
+        eof = (size_t)got < STREAM_CHUNK_BYTES - carried;
+
+        // only whole lines are parsed, the last partial one waits for the next chunk
+        char *end = buffer + carried + got;
+        char *last = eof ? end : memrchr(buffer, '\n', end - buffer);
+        if (last == NULL)
+        {
+            printf("\nLine %zu of %s is longer than %d bytes\n", line_number + 1, stream->file_path, STREAM_CHUNK_BYTES);
+            result = -1;
+            break;
+        }
+
+        char *line = buffer;
+        while (line < last || (eof && line < end))
+        {
+            char *line_end = memchr(line, '\n', end - line);
+            if (line_end == NULL)
+                line_end = end;
+            line_number++;
+
+            int parsed = parse_line(line, line_end, &batch[batched]);
+            if (parsed == -1)
+            {
+                printf("\nMalformed line %zu in %s, expected %d integers\n", line_number, stream->file_path, WORKLOAD_COLUMNS);
+                result = -1;
+                break;
+            }
+            batched += parsed;
+            if (batched == STREAM_BATCH)
+            {
+                if (!publish_records(stream, batch, batched))
+                {
+                    result = -1;
+                    break;
+                }
+                batched = 0;
+            }
+            line = line_end + 1;
+        }
+        carried = line < end ? end - line : 0;
+        memmove(buffer, line, carried);
+    }
+
+    // the processes before an error are still handed out
+    if (!publish_records(stream, batch, batched))
+        result = -1;
+    free(buffer);
+    return result;
+}
+
+static int stream_binary(workload_stream_t *stream, process_info_t *batch)
+{
+    uint64_t hash = WORKLOAD_CHECKSUM_INIT;
+    size_t remaining = stream->expected;
+
+    while (remaining > 0)
+    {
+        size_t wanted = remaining < STREAM_BATCH ? remaining : STREAM_BATCH;
+        ssize_t got = read_fully(stream->fd, batch, wanted * sizeof(process_info_t));
+        if (got != (ssize_t)(wanted * sizeof(process_info_t)))
+        {
+            printf("\nCould not read the records of %s\n", stream->file_path);
+            return -1;
+        }
+        stream->bytes += got;
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+        swap_records(batch, wanted);
+#endif
+        hash = workload_checksum_update(hash, batch, wanted);
+        if (!publish_records(stream, batch, wanted))
+            return -1;
+        remaining -= wanted;
+    }
+
+    // the records are already handed out, a bad checksum can only be reported
+    if (hash != stream->checksum)
+        printf("\nChecksum mismatch in %s\n", stream->file_path);
+    return 0;
+}
+
+/*
+ * Body of the reader thread, it parses the file into the window until the end
+ * of the file, an error or close_workload_stream().
+ */
+static void *stream_reader(void *arg)
+{
+    workload_stream_t *stream = arg;
+    struct timespec start;
+    process_info_t *batch = malloc(sizeof(process_info_t) * STREAM_BATCH);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int result = -1;
+    if (batch == NULL)
+        perror("Could not allocate the stream batch");
+    else
+        result = stream->format == WORKLOAD_BINARY ? stream_binary(stream, batch) : stream_text(stream, batch);
+    free(batch);
+
+    pthread_mutex_lock(&stream->lock);
+    stream->parse_seconds = elapsed_seconds(&start);
+    stream->error = result == -1 && !stream->closing;
+    stream->done = true;
+    pthread_cond_signal(&stream->not_empty);
+    pthread_mutex_unlock(&stream->lock);
+    return NULL;
+}
+
+int open_workload_stream(workload_stream_t *stream, const char *file_path, size_t capacity)
+{
+    struct stat file_stat;
+    workload_header_t header;
+
+    memset(stream, 0, sizeof(*stream));
+    stream->file_path = file_path;
+    stream->last_arrival = INT_MIN;
+    stream->fd = open(file_path, O_RDONLY);
+    if (stream->fd == -1 || fstat(stream->fd, &file_stat) == -1)
+    {
+        printf("\nCould not open file %s!!\n", file_path);
+        if (stream->fd != -1)
+            close(stream->fd);
+        return -1;
+    }
+    stream->file_bytes = file_stat.st_size;
+    posix_fadvise(stream->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    ssize_t got = stream->file_bytes >= sizeof(header) ? read_fully(stream->fd, &header, sizeof(header)) : 0;
+    if (got == sizeof(header) && memcmp(header.magic, WORKLOAD_MAGIC, 8) == 0)
+    {
+        if (!valid_header(&header, stream->file_bytes))
+        {
+            printf("\nCorrupted binary workload %s\n", file_path);
+            close(stream->fd);
+            return -1;
+        }
+        stream->format = WORKLOAD_BINARY;
+        stream->expected = le64toh(header.count);
+        stream->checksum = le64toh(header.checksum);
+        stream->bytes = sizeof(header);
+    }
+    else if (lseek(stream->fd, 0, SEEK_SET) == -1)
+    {
+        perror("Could not rewind the processes file");
+        close(stream->fd);
+        return -1;
+    }
+
+    stream->capacity = 1;
+    while (stream->capacity < capacity)
+        stream->capacity <<= 1;
+    stream->window = malloc(sizeof(process_info_t) * stream->capacity);
+    if (stream->window == NULL)
+    {
+        perror("Could not allocate the stream window");
+        close(stream->fd);
+        return -1;
+    }
+    pthread_mutex_init(&stream->lock, NULL);
+    pthread_cond_init(&stream->not_empty, NULL);
+    pthread_cond_init(&stream->not_full, NULL);
+
+    // signals are left to the threads of the caller
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    int created = pthread_create(&stream->reader, NULL, stream_reader, stream);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (created != 0)
+    {
+        printf("\nCould not start the reader of %s\n", file_path);
+        free(stream->window);
+        close(stream->fd);
+        return -1;
+    }
+    return 0;
+}
+
+process_info_t *peek_workload_stream(workload_stream_t *stream)
+{
+    size_t head = stream->head;
+
+    if (head == __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE))
+    {
+        pthread_mutex_lock(&stream->lock);
+        while (head == stream->tail && !stream->done)
+            pthread_cond_wait(&stream->not_empty, &stream->lock);
+        bool empty = head == stream->tail;
+        pthread_mutex_unlock(&stream->lock);
+        if (empty)
+            return NULL;
+    }
+    return &stream->window[head & (stream->capacity - 1)];
+}
+
+void pop_workload_stream(workload_stream_t *stream)
+{
+    size_t head = stream->head + 1;
+
+    __atomic_store_n(&stream->head, head, __ATOMIC_RELEASE);
+    // waking the reader for every record would cost more than parsing it
+    if ((head & (stream->capacity / 4 - 1)) == 0 || stream->capacity < 4)
+    {
+        pthread_mutex_lock(&stream->lock);
+        pthread_cond_signal(&stream->not_full);
+        pthread_mutex_unlock(&stream->lock);
+    }
+}
+
+void close_workload_stream(workload_stream_t *stream)
+{
+    pthread_mutex_lock(&stream->lock);
+    stream->closing = true;
+    pthread_cond_signal(&stream->not_full);
+    pthread_mutex_unlock(&stream->lock);
+
+    pthread_join(stream->reader, NULL);
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->not_empty);
+    pthread_cond_destroy(&stream->not_full);
+    free(stream->window);
+    close(stream->fd);
+    stream->window = NULL;
+}
+
+/*
+ * Orders the streams of the heap by their next arrival, then by file.
+ */
+static bool merge_before(const workload_merge_t *merge, size_t a, size_t b)
+{
+    if (merge->heap[a].arrival != merge->heap[b].arrival)
+        return merge->heap[a].arrival < merge->heap[b].arrival;
+    return merge->heap[a].stream < merge->heap[b].stream;
+}
+
+static void merge_swap(workload_merge_t *merge, size_t a, size_t b)
+{
+    merge_entry_t entry = merge->heap[a];
+    merge->heap[a] = merge->heap[b];
+    merge->heap[b] = entry;
+}
+
+static void merge_sift_down(workload_merge_t *merge, size_t i)
+{
+    while (1)
+    {
+        size_t smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+        if (left < merge->heap_size && merge_before(merge, left, smallest))
+            smallest = left;
+        if (right < merge->heap_size && merge_before(merge, right, smallest))
+            smallest = right;
+        if (smallest == i)
+            return;
+        merge_swap(merge, i, smallest);
+        i = smallest;
+    }
+}
+
+int open_workload_merge(workload_merge_t *merge, char *const file_paths[], size_t file_count, size_t capacity)
+{
+    size_t window = capacity / file_count > MERGE_MIN_WINDOW ? capacity / file_count : MERGE_MIN_WINDOW;
+
+    memset(merge, 0, sizeof(*merge));
+    merge->streams = malloc(sizeof(workload_stream_t) * file_count);
+    merge->heap = malloc(sizeof(*merge->heap) * file_count);
+    if (merge->streams == NULL || merge->heap == NULL)
+    {
+        perror("Could not allocate the merge");
+        free(merge->streams);
+        free(merge->heap);
+        return -1;
+    }
+    for (; merge->stream_count < file_count; merge->stream_count++)
+    {
+        if (open_workload_stream(&merge->streams[merge->stream_count], file_paths[merge->stream_count], window) == -1)
+        {
+            close_workload_merge(merge);
+            return -1;
+        }
+    }
+
+    // every stream enters the heap with its first process, the empty ones never do
+    for (size_t i = 0; i < file_count; i++)
+    {
+        process_info_t *process = peek_workload_stream(&merge->streams[i]);
+        if (process == NULL)
+            continue;
+        merge->heap[merge->heap_size].arrival = process->arrival;
+        merge->heap[merge->heap_size].stream = i;
+        merge->heap_size++;
+    }
+    for (size_t i = merge->heap_size / 2; i-- > 0;)
+        merge_sift_down(merge, i);
+    merge->renumber = file_count > 1;
+    return 0;
+}
+
+process_info_t *peek_workload_merge(workload_merge_t *merge)
+{
+    if (merge->heap_size == 0)
+        return NULL;
+
+    process_info_t *process = peek_workload_stream(&merge->streams[merge->heap[0].stream]);
+    if (!merge->renumber)
+        return process;
+    merge->current = *process;
+    merge->current.id = merge->count + 1;
+    return &merge->current;
+}
+
+void pop_workload_merge(workload_merge_t *merge)
+{
+    workload_stream_t *stream = &merge->streams[merge->heap[0].stream];
+
+    pop_workload_stream(stream);
+    merge->count++;
+    process_info_t *next = peek_workload_stream(stream);
+    if (next != NULL)
+        merge->heap[0].arrival = next->arrival;
+    else
+        merge->heap[0] = merge->heap[--merge->heap_size];
+    merge_sift_down(merge, 0);
+}
+
+void close_workload_merge(workload_merge_t *merge)
+{
+    for (size_t i = 0; i < merge->stream_count; i++)
+        close_workload_stream(&merge->streams[i]);
+    free(merge->streams);
+    free(merge->heap);
+    merge->streams = NULL;
+    merge->heap = NULL;
+    merge->heap_size = 0;
+}
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "header.h"
+
+#define WORKLOAD_MAGIC "SYNWKLD\0" /* first 8 bytes of a binary workload */
+#define WORKLOAD_VERSION 1
+#define WORKLOAD_TEXT_HEADER "#id arrival runtime priority memsize\n"
+#define WORKLOAD_STREAM_WINDOW (1 << 16) /* processes a stream reads ahead of its consumer */
+#define WORKLOAD_CHECKSUM_INIT 14695981039346656037ULL /* FNV-1a offset basis */
+
+/**
+ * workload_format - Formats a processes file can be stored in
+ * @WORKLOAD_TEXT: one process per line, five integers separated by blanks, '#' starts a comment
+ * @WORKLOAD_BINARY: a workload_header_t followed by fixed-size little-endian records
+ */
+typedef enum
+{
+    WORKLOAD_TEXT = 0,
+    WORKLOAD_BINARY
+} workload_format;
+
+/**
+ * struct workload_header_s - Header of a binary workload, every field is little-endian
+ * @magic: WORKLOAD_MAGIC
+ * @version: WORKLOAD_VERSION
+ * @record_size: size of one record, sizeof(process_info_t)
+ * @count: number of records following the header
+ * @first_arrival: arrival time of the first record
+ * @last_arrival: arrival time of the last record
+ * @checksum: workload_checksum() of the records
+ *
+ * Description: A record holds id, arrival, runtime, priority and memsize as
+ *              32-bit integers, the same layout as process_info_t.
+ */
+typedef struct workload_header_s
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t count;
+    int32_t first_arrival;
+    int32_t last_arrival;
+    uint64_t checksum;
+} workload_header_t;
+
+/**
+ * struct workload_s - The processes of an input file, sorted by arrival as in the file
+ * @processes: one contiguous array holding every process of the file
+ * @count: number of processes in @processes
+ * @bytes: size of the parsed file in bytes
+ * @parse_seconds: wall time spent parsing the file
+ * @format: format the file was stored in
+ * @checksum: checksum stored in the header of a binary file
+ * @mapping: the mapped binary file when @processes points straight into it, NULL otherwise
+ */
+typedef struct workload_s
+{
+    process_info_t *processes;
+    size_t count;
+    size_t bytes;
+    double parse_seconds;
+    workload_format format;
+    uint64_t checksum;
+    void *mapping;
+} workload_t;
+
+/**
+ * struct workload_stream_s - A processes file read ahead by a thread into a bounded window
+ * @file_path: path of the file
+ * @fd: the open file
+ * @format: format of the file
+ * @file_bytes: size of the file in bytes
+ * @bytes: bytes read so far
+ * @count: processes parsed into the window so far
+ * @expected: number of records announced by the header of a binary file
+ * @checksum: checksum stored in the header of a binary file
+ * @parse_seconds: wall time the reader took to go through the file, set once @done
+ * @done: the reader stopped, at the end of the file or on an error
+ * @error: the file turned out malformed or could not be read
+ * @closing: close_workload_stream() asked the reader to stop
+ * @unsorted: processes that arrive before the process read before them
+ * @last_arrival: arrival of the last process read
+ * @window: ring of @capacity processes, [@head, @tail) are parsed and not consumed yet
+ * @capacity: size of @window, a power of two
+ * @head: processes consumed, only written by the consumer
+ * @tail: processes parsed, only written by the reader
+ * @reader: the reader thread
+ * @lock: guards the sleeping of both sides and the fields the reader sets at the end
+ * @not_empty: signaled when the reader publishes processes or stops
+ * @not_full: signaled when the consumer frees a quarter of the window
+ *
+ * Description: Memory stays bounded by the window whatever the size of the file, and
+ *              the first processes are available as soon as the first chunk is parsed.
+ */
+typedef struct workload_stream_s
+{
+    const char *file_path;
+    int fd;
+    workload_format format;
+    size_t file_bytes;
+    size_t bytes;
+    size_t count;
+    size_t expected;
+    uint64_t checksum;
+    double parse_seconds;
+    bool done;
+    bool error;
+    bool closing;
+    size_t unsorted;
+    int last_arrival;
+    process_info_t *window;
+    size_t capacity;
+    size_t head;
+    size_t tail;
+    pthread_t reader;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} workload_stream_t;
+
+/**
+ * struct merge_entry_s - A stream waiting in the heap of a merge
+ * @arrival: arrival time of the next process of the stream
+ * @stream: index of the stream
+ */
+typedef struct merge_entry_s
+{
+    int arrival;
+    size_t stream;
+} merge_entry_t;
+
+/**
+ * struct workload_merge_s - Processes files merged by arrival time as they are streamed
+ * @streams: one stream per file
+ * @stream_count: number of files
+ * @heap: the streams that have processes left, a binary min-heap on (next arrival, file)
+ * @heap_size: number of streams in @heap
+ * @count: processes consumed so far
+ * @renumber: give the processes new ids, set when several files are merged
+ * @current: the next process when it is renumbered
+ *
+ * Description: Each file must be sorted by arrival. Processes arriving at the same
+ *              time keep the order of the files. With several files the processes are
+ *              renumbered 1, 2, ... in merged order so ids stay unique; a single file
+ *              keeps its ids, as do merges that clear @renumber.
+ */
+typedef struct workload_merge_s
+{
+    workload_stream_t *streams;
+    size_t stream_count;
+    merge_entry_t *heap;
+    size_t heap_size;
+    size_t count;
+    bool renumber;
+    process_info_t current;
+} workload_merge_t;
+
+/**
+ * struct workload_writer_s - A processes file written a few records at a time
+ * @file: the open file
+ * @file_path: path of the file
+ * @format: format of the file
+ * @count: records written so far
+ * @checksum: workload_checksum() of the records written so far
+ * @first_arrival: arrival of the first record
+ * @last_arrival: arrival of the last record
+ */
+typedef struct workload_writer_s
+{
+    FILE *file;
+    const char *file_path;
+    workload_format format;
+    size_t count;
+    uint64_t checksum;
+    int first_arrival;
+    int last_arrival;
+} workload_writer_t;
+
+/**
+ * load_workload - maps a processes file and parses it into a workload.
+ * @param workload: the workload to fill, release it with free_workload().
+ * @param file_path: path of the processes file, text or binary.
+ * @return 0 on success, -1 if the file can not be read or is malformed.
+ *
+ * Description: The format is detected from the magic. Lines of a text file starting
+ *              with '#' are comments, blank lines are skipped and every other line holds
+ *              five integers: id, arrival, runtime, priority and memsize. The file is
+ *              parsed in place from an mmap, the only allocation is the array.
+ *              The records of a binary file are used in place, nothing is copied on a
+ *              little-endian host; its checksum is only checked by verify_workload().
+ */
+int load_workload(workload_t *workload, const char *file_path);
+
+/**
+ * save_workload - writes a workload to a file.
+ * @param workload: the workload to write.
+ * @param file_path: path of the file, it is truncated.
+ * @param format: format to write the file in.
+ * @return 0 on success, -1 on failure.
+ */
+int save_workload(const workload_t *workload, const char *file_path, workload_format format);
+
+/**
+ * workload_checksum - FNV-1a over the little-endian bytes of the records.
+ * @param processes: the records.
+ * @param count: number of records.
+ * @return the checksum.
+ */
+uint64_t workload_checksum(const process_info_t *processes, size_t count);
+
+/**
+ * workload_checksum_update - continues a workload_checksum() over more records.
+ * @param hash: the checksum of the records before, WORKLOAD_CHECKSUM_INIT for none.
+ * @param processes: the records.
+ * @param count: number of records.
+ * @return the checksum of all the records.
+ */
+uint64_t workload_checksum_update(uint64_t hash, const process_info_t *processes, size_t count);
+
+/**
+ * verify_workload - checks the records of a binary workload against its header.
+ * @param workload: a loaded workload.
+ * @return 0 if the checksum matches or the workload was loaded from text, -1 otherwise.
+ */
+int verify_workload(const workload_t *workload);
+
+/**
+ * free_workload - releases the array of a workload.
+ * @param workload: the workload to release.
+ */
+void free_workload(workload_t *workload);
+
+/**
+ * open_workload_stream - opens a processes file and starts reading it ahead.
+ * @param stream: the stream to fill, release it with close_workload_stream().
+ * @param file_path: path of the processes file, text or binary, it must outlive the stream.
+ * @param capacity: number of processes to read ahead, rounded up to a power of two.
+ * @return 0 on success, -1 if the file can not be opened or has a corrupted binary header.
+ *
+ * Description: The file is parsed by a thread with read() in chunks, never mapped
+ *              as a whole. A malformed line is only found when the reader reaches it,
+ *              the stream then ends there with @error set. The checksum of a binary
+ *              file is checked at its end, once the records have been handed out.
+ */
+int open_workload_stream(workload_stream_t *stream, const char *file_path, size_t capacity);
+
+/**
+ * peek_workload_stream - returns the next process of a stream without consuming it.
+ * @param stream: the stream, used by a single consumer thread.
+ * @return the process, valid until pop_workload_stream(), or NULL at the end of the stream.
+ *
+ * Description: Blocks while the reader is behind.
+ */
+process_info_t *peek_workload_stream(workload_stream_t *stream);
+
+/**
+ * pop_workload_stream - consumes the process returned by peek_workload_stream().
+ * @param stream: the stream.
+ */
+void pop_workload_stream(workload_stream_t *stream);
+
+/**
+ * close_workload_stream - stops the reader of a stream and releases it.
+ * @param stream: the stream, it may be closed before its end.
+ */
+void close_workload_stream(workload_stream_t *stream);
+
+/**
+ * open_workload_merge - streams several processes files and merges them by arrival.
+ * @param merge: the merge to fill, release it with close_workload_merge().
+ * @param file_paths: paths of the files, text or binary, they must outlive the merge.
+ * @param file_count: number of files, at least one.
+ * @param capacity: number of processes read ahead in total, split between the files.
+ * @return 0 on success, -1 if a file can not be opened.
+ */
+int open_workload_merge(workload_merge_t *merge, char *const file_paths[], size_t file_count, size_t capacity);
+
+/**
+ * peek_workload_merge - returns the next process of the merge without consuming it.
+ * @param merge: the merge.
+ * @return the process, valid until pop_workload_merge(), or NULL once every file ended.
+ */
+process_info_t *peek_workload_merge(workload_merge_t *merge);
+
+/**
+ * pop_workload_merge - consumes the process returned by peek_workload_merge().
+ * @param merge: the merge.
+ */
+void pop_workload_merge(workload_merge_t *merge);
+
+/**
+ * close_workload_merge - closes every stream of a merge.
+ * @param merge: the merge.
+ */
+void close_workload_merge(workload_merge_t *merge);
+
+/**
+ * open_workload_writer - creates a processes file to be written record by record.
+ * @param writer: the writer to fill.
+ * @param file_path: path of the file, it is truncated and must outlive the writer.
+ * @param format: format to write the file in.
+ * @return 0 on success, -1 if the file can not be created.
+ */
+int open_workload_writer(workload_writer_t *writer, const char *file_path, workload_format format);
+
+/**
+ * write_workload_records - appends records to a processes file.
+ * @param writer: the writer.
+ * @param processes: the records, in arrival order.
+ * @param count: number of records.
+ * @return 0 on success, -1 on failure.
+ */
+int write_workload_records(workload_writer_t *writer, const process_info_t *processes, size_t count);
+
+/**
+ * close_workload_writer - completes the header of a binary file and closes it.
+ * @param writer: the writer.
+ * @return 0 on success, -1 if the file could not be written.
+ */
+int close_workload_writer(workload_writer_t *writer);
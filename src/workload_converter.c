@@ -0,0 +1,99 @@
+#include <stdbool.h>
+#include "workload_sort.h"
+
+/*
+ * Tells the format of a processes file from its magic.
+ */
+static workload_format file_format(const char *file_path)
+{
+    char magic[8] = {0};
+    FILE *file = fopen(file_path, "r");
+    if (file != NULL)
+    {
+        if (fread(magic, 1, sizeof(magic), file) != sizeof(magic))
+            magic[0] = 0;
+        fclose(file);
+    }
+    return memcmp(magic, WORKLOAD_MAGIC, 8) == 0 ? WORKLOAD_BINARY : WORKLOAD_TEXT;
+}
+
+/**
+ * main - converts a processes file between the text and the binary format
+ *
+ * Description: The output is in the other format than the input unless -t or -b
+ *              forces one. -c only checks the file: it is parsed and the checksum
+ *              of a binary file is verified. -s sorts the file by arrival with an
+ *              external merge sort bounded by -m megabytes and run on -j threads,
+ *              the output then keeps the input's format unless -t or -b forces one.
+ */
+int main(int argc, char *argv[]) // [-t | -b | -c] [-s [-m megabytes] [-j threads]] input_file [output_file]
+{
+    bool check_only = false, sort = false;
+    int forced_format = -1;
+    size_t memory = WORKLOAD_SORT_MEMORY;
+    int threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int opt;
+
+    while ((opt = getopt(argc, argv, "tbcsm:j:")) != -1)
+    {
+        if (opt == 't')
+            forced_format = WORKLOAD_TEXT;
+        else if (opt == 'b')
+            forced_format = WORKLOAD_BINARY;
+        else if (opt == 'c')
+            check_only = true;
+        else if (opt == 's')
+            sort = true;
+        else if (opt == 'm')
+            memory = (size_t)atol(optarg) << 20;
+        else if (opt == 'j')
+            threads = atoi(optarg);
+        else
+            optind = argc + 1;
+    }
+    if (argc - optind != (check_only ? 1 : 2) || (check_only && sort) || memory == 0 || threads < 1)
+    {
+        printf("Use: ./workload_converter [-t | -b] <input_file> <output_file>\n");
+        printf("     ./workload_converter -s [-t | -b] [-m <megabytes>] [-j <threads>] <input_file> <output_file>\n");
+        printf("     ./workload_converter -c <input_file>\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (sort)
+    {
+        workload_format format = forced_format != -1 ? (workload_format)forced_format : file_format(argv[optind]);
+        workload_sort_stats_t stats;
+        if (sort_workload(argv[optind], argv[optind + 1], format, memory, threads, &stats) == -1)
+            exit(EXIT_FAILURE);
+        printf("Sorted %zu processes in %.3f s: %zu runs, %d merge passes, %zu MB of memory, %d threads\n",
+               stats.count, stats.seconds, stats.runs, stats.passes, memory >> 20, threads);
+        printf("Wrote %s as %s\n", argv[optind + 1], format == WORKLOAD_BINARY ? "binary" : "text");
+        return 0;
+    }
+
+    workload_t workload;
+    if (load_workload(&workload, argv[optind]) == -1)
+        exit(EXIT_FAILURE);
+    printf("Loaded %zu processes (%s) in %.3f s\n", workload.count,
+           workload.format == WORKLOAD_BINARY ? "binary" : "text", workload.parse_seconds);
+
+    if (verify_workload(&workload) == -1)
+    {
+        printf("Checksum mismatch in %s\n", argv[optind]);
+        free_workload(&workload);
+        exit(EXIT_FAILURE);
+    }
+    if (check_only)
+    {
+        free_workload(&workload);
+        return 0;
+    }
+
+    workload_format format = forced_format != -1 ? (workload_format)forced_format
+                                                 : (workload.format == WORKLOAD_TEXT ? WORKLOAD_BINARY : WORKLOAD_TEXT);
+    int result = save_workload(&workload, argv[optind + 1], format);
+    if (result == 0)
+        printf("Wrote %s as %s\n", argv[optind + 1], format == WORKLOAD_BINARY ? "binary" : "text");
+    free_workload(&workload);
+    return result == 0 ? 0 : EXIT_FAILURE;
+}
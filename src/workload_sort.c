@@ -0,0 +1,370 @@
+#include "workload_sort.h"
+#include <libgen.h>
+#include <limits.h>
+#include <time.h>
+
+#define SORT_MIN_RUN 4096        /* smallest run, whatever the memory budget */
+#define SORT_RADIX_BUCKETS 65536 /* the 32-bit arrival is sorted 16 bits at a time */
+#define SORT_PATH_SIZE 4096
+#define SORT_DIR_SIZE (SORT_PATH_SIZE - 64) /* leaves room for the name of a run */
+
+/**
+ * struct sort_job_s - A run read from the input, waiting to be sorted and written
+ * @records: the processes of the run
+ * @count: number of processes
+ * @run: index of the run, it names its file
+ */
+typedef struct sort_job_s
+{
+    process_info_t *records;
+    size_t count;
+    size_t run;
+} sort_job_t;
+
+/**
+ * struct sorter_s - State shared by the reader and the threads sorting runs
+ * @run_dir: directory of the run files
+ * @run_records: processes in a full run
+ * @free_buffers: buffers the reader can fill
+ * @free_count: number of buffers in @free_buffers
+ * @jobs: runs read and not sorted yet
+ * @job_count: number of runs in @jobs
+ * @done: the reader reached the end of the input
+ * @failed: a run could not be written
+ * @lock: guards everything above that changes
+ * @changed: broadcast when a buffer or a job is handed over
+ */
+typedef struct sorter_s
+{
+    const char *run_dir;
+    size_t run_records;
+    process_info_t **free_buffers;
+    size_t free_count;
+    sort_job_t *jobs;
+    size_t job_count;
+    bool done;
+    bool failed;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} sorter_t;
+
+static void run_path(char *path, const char *run_dir, int pass, size_t run)
+{
+    snprintf(path, SORT_PATH_SIZE, "%s/run-%d-%zu.bin", run_dir, pass, run);
+}
+
+/*
+ * Stable LSD radix sort on the arrival, two passes of 16 bits leave the result in records.
+ */
+static void radix_sort(process_info_t *records, process_info_t *scratch, size_t count, size_t *buckets)
+{
+    process_info_t *from = records, *to = scratch;
+
+    for (int shift = 0; shift < 32; shift += 16)
+    {
+        memset(buckets, 0, sizeof(size_t) * SORT_RADIX_BUCKETS);
+        // flipping the sign bit orders negative arrivals first
+        for (size_t i = 0; i < count; i++)
+            buckets[(((uint32_t)from[i].arrival ^ 0x80000000u) >> shift) & 0xffff]++;
+        size_t offset = 0;
+        for (size_t b = 0; b < SORT_RADIX_BUCKETS; b++)
+        {
+            size_t size = buckets[b];
+            buckets[b] = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < count; i++)
+            to[buckets[(((uint32_t)from[i].arrival ^ 0x80000000u) >> shift) & 0xffff]++] = from[i];
+
+        process_info_t *swap = from;
+        from = to;
+        to = swap;
+    }
+}
+
+static int write_run(const char *path, const process_info_t *records, size_t count)
+{
+    workload_writer_t writer;
+    if (open_workload_writer(&writer, path, WORKLOAD_BINARY) == -1)
+        return -1;
+    if (write_workload_records(&writer, records, count) == -1)
+    {
+        fclose(writer.file);
+        return -1;
+    }
+    return close_workload_writer(&writer);
+}
+
+/*
+ * Body of the threads sorting runs, they take jobs until the reader is done.
+ */
+static void *sort_runs(void *arg)
+{
+    sorter_t *sorter = arg;
+    process_info_t *scratch = malloc(sizeof(process_info_t) * sorter->run_records);
+    size_t *buckets = malloc(sizeof(size_t) * SORT_RADIX_BUCKETS);
+    char path[SORT_PATH_SIZE];
+
+    while (1)
+    {
+        pthread_mutex_lock(&sorter->lock);
+        while (sorter->job_count == 0 && !sorter->done)
+            pthread_cond_wait(&sorter->changed, &sorter->lock);
+        if (sorter->job_count == 0 || scratch == NULL || buckets == NULL)
+        {
+            sorter->failed = sorter->failed || scratch == NULL || buckets == NULL;
+            pthread_mutex_unlock(&sorter->lock);
+            break;
+        }
+        sort_job_t job = sorter->jobs[--sorter->job_count];
+        pthread_mutex_unlock(&sorter->lock);
+
+        radix_sort(job.records, scratch, job.count, buckets);
+        run_path(path, sorter->run_dir, 0, job.run);
+        int result = write_run(path, job.records, job.count);
+
+        pthread_mutex_lock(&sorter->lock);
+        sorter->free_buffers[sorter->free_count++] = job.records;
+        sorter->failed = sorter->failed || result == -1;
+        pthread_cond_broadcast(&sorter->changed);
+        pthread_mutex_unlock(&sorter->lock);
+    }
+
+    free(scratch);
+    free(buckets);
+    return NULL;
+}
+
+/*
+ * Streams the input into sorted runs. Returns the number of runs or -1 on failure.
+ */
+static long make_runs(const char *input_path, sorter_t *sorter, int threads, size_t *count)
+{
+    workload_stream_t stream;
+    size_t buffer_count = threads + 1;
+    long runs = 0;
+
+    if (open_workload_stream(&stream, input_path, WORKLOAD_STREAM_WINDOW) == -1)
+        return -1;
+    sorter->free_buffers = calloc(buffer_count, sizeof(process_info_t *));
+    sorter->jobs = malloc(sizeof(sort_job_t) * buffer_count);
+    bool allocated = sorter->free_buffers != NULL && sorter->jobs != NULL;
+    for (size_t i = 0; allocated && i < buffer_count; i++)
+    {
+        sorter->free_buffers[i] = malloc(sizeof(process_info_t) * sorter->run_records);
+        allocated = sorter->free_buffers[i] != NULL;
+        sorter->free_count += allocated;
+    }
+    pthread_mutex_init(&sorter->lock, NULL);
+    pthread_cond_init(&sorter->changed, NULL);
+
+    pthread_t workers[threads];
+    int started = 0;
+    while (allocated && started < threads && pthread_create(&workers[started], NULL, sort_runs, sorter) == 0)
+        started++;
+
+    // the reader fills a buffer while the workers sort the previous ones
+    *count = 0;
+    bool more = started > 0;
+    while (more)
+    {
+        pthread_mutex_lock(&sorter->lock);
+        while (sorter->free_count == 0 && !sorter->failed)
+            pthread_cond_wait(&sorter->changed, &sorter->lock);
+        process_info_t *buffer = sorter->failed ? NULL : sorter->free_buffers[--sorter->free_count];
+        pthread_mutex_unlock(&sorter->lock);
+        if (buffer == NULL)
+            break;
+
+        size_t filled = 0;
+        process_info_t *process;
+        while (filled < sorter->run_records && (process = peek_workload_stream(&stream)) != NULL)
+        {
+            buffer[filled++] = *process;
+            pop_workload_stream(&stream);
+        }
+        more = filled == sorter->run_records;
+        *count += filled;
+
+        pthread_mutex_lock(&sorter->lock);
+        if (filled > 0)
+            sorter->jobs[sorter->job_count++] = (sort_job_t){buffer, filled, runs++};
+        else
+            sorter->free_buffers[sorter->free_count++] = buffer;
+        pthread_cond_broadcast(&sorter->changed);
+        pthread_mutex_unlock(&sorter->lock);
+    }
+
+    pthread_mutex_lock(&sorter->lock);
+    sorter->done = true;
+    pthread_cond_broadcast(&sorter->changed);
+    pthread_mutex_unlock(&sorter->lock);
+    for (int i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    bool failed = !allocated || started == 0 || sorter->failed || stream.error;
+    if (!allocated || started == 0)
+        perror("Could not start sorting runs");
+    close_workload_stream(&stream);
+    for (size_t i = 0; i < sorter->free_count; i++)
+        free(sorter->free_buffers[i]);
+    free(sorter->free_buffers);
+    free(sorter->jobs);
+    pthread_mutex_destroy(&sorter->lock);
+    pthread_cond_destroy(&sorter->changed);
+    return failed ? -1 : runs;
+}
+
+/*
+ * Merges the runs [first, first + count) of a pass into one file, the runs are removed.
+ */
+static int merge_runs(const char *run_dir, int pass, size_t first, size_t count, const char *output_path,
+                      workload_format format)
+{
+    char *names = malloc(SORT_PATH_SIZE * count);
+    char **paths = calloc(count, sizeof(char *));
+    process_info_t *batch = malloc(sizeof(process_info_t) * SORT_MIN_RUN);
+    workload_merge_t merge;
+    workload_writer_t writer;
+    int result = -1;
+
+    if (names == NULL || paths == NULL || batch == NULL)
+    {
+        perror("Could not allocate the merge");
+        free(names);
+        free(paths);
+        free(batch);
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        paths[i] = names + i * SORT_PATH_SIZE;
+        run_path(paths[i], run_dir, pass, first + i);
+    }
+
+    if (open_workload_merge(&merge, paths, count, WORKLOAD_STREAM_WINDOW) == 0)
+    {
+        // runs are pieces of one file, their ids are kept
+        merge.renumber = false;
+        if (open_workload_writer(&writer, output_path, format) == 0)
+        {
+            process_info_t *process;
+            size_t batched = 0;
+            result = 0;
+            while (result == 0 && (process = peek_workload_merge(&merge)) != NULL)
+            {
+                batch[batched++] = *process;
+                pop_workload_merge(&merge);
+                if (batched == SORT_MIN_RUN)
+                {
+                    result = write_workload_records(&writer, batch, batched);
+                    batched = 0;
+                }
+            }
+            if (result == 0)
+                result = write_workload_records(&writer, batch, batched);
+            for (size_t i = 0; i < merge.stream_count; i++)
+                result = merge.streams[i].error ? -1 : result;
+            if (result == -1)
+                fclose(writer.file);
+            else
+                result = close_workload_writer(&writer);
+        }
+        close_workload_merge(&merge);
+    }
+
+    for (size_t i = 0; i < count; i++)
+        unlink(paths[i]);
+    free(names);
+    free(paths);
+    free(batch);
+    return result;
+}
+
+int is_workload_sorted(const char *file_path)
+{
+    workload_stream_t stream;
+    if (open_workload_stream(&stream, file_path, WORKLOAD_STREAM_WINDOW) == -1)
+        return -1;
+
+    int last_arrival = INT_MIN, sorted = 1;
+    process_info_t *process;
+    while (sorted && (process = peek_workload_stream(&stream)) != NULL)
+    {
+        sorted = process->arrival >= last_arrival;
+        last_arrival = process->arrival;
+        pop_workload_stream(&stream);
+    }
+    if (sorted && stream.error)
+        sorted = -1;
+    close_workload_stream(&stream);
+    return sorted;
+}
+
+int sort_workload(const char *input_path, const char *output_path, workload_format format, size_t memory,
+                  int threads, workload_sort_stats_t *stats)
+{
+    struct timespec start, end;
+    char output_dir[SORT_DIR_SIZE], run_dir[SORT_DIR_SIZE], path[SORT_PATH_SIZE];
+    workload_sort_stats_t sort_stats = {0};
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    snprintf(output_dir, sizeof(output_dir), "%s", output_path);
+    snprintf(run_dir, sizeof(run_dir), "%s/.synergify-sort-XXXXXX", dirname(output_dir));
+    if (mkdtemp(run_dir) == NULL)
+    {
+        perror("Could not create the directory of the sorted runs");
+        return -1;
+    }
+
+    // every thread holds a run and its scratch, the reader holds one more run
+    if (threads < 1)
+        threads = 1;
+    sorter_t sorter = {.run_dir = run_dir};
+    sorter.run_records = memory / sizeof(process_info_t) / (2 * threads + 1);
+    if (sorter.run_records < SORT_MIN_RUN)
+        sorter.run_records = SORT_MIN_RUN;
+    long runs = make_runs(input_path, &sorter, threads, &sort_stats.count);
+    int result = runs == -1 ? -1 : 0;
+    sort_stats.runs = runs == -1 ? 0 : runs;
+
+    // every pass merges groups of runs into the runs of the next pass
+    size_t run_count = sort_stats.runs;
+    while (result == 0 && run_count > WORKLOAD_SORT_FAN_IN)
+    {
+        size_t merged = 0;
+        for (size_t first = 0; result == 0 && first < run_count; first += WORKLOAD_SORT_FAN_IN, merged++)
+        {
+            size_t count = run_count - first < WORKLOAD_SORT_FAN_IN ? run_count - first : WORKLOAD_SORT_FAN_IN;
+            run_path(path, run_dir, sort_stats.passes + 1, merged);
+            result = merge_runs(run_dir, sort_stats.passes, first, count, path, WORKLOAD_BINARY);
+        }
+        sort_stats.passes++;
+        run_count = merged;
+    }
+    if (result == 0 && run_count == 0)
+    {
+        workload_writer_t writer;
+        result = open_workload_writer(&writer, output_path, format) == 0 ? close_workload_writer(&writer) : -1;
+    }
+    else if (result == 0)
+    {
+        result = merge_runs(run_dir, sort_stats.passes, 0, run_count, output_path, format);
+        sort_stats.passes++;
+    }
+
+    // a failed sort may leave runs behind
+    for (int pass = 0; result == -1 && pass <= sort_stats.passes + 1; pass++)
+        for (size_t run = 0; run < sort_stats.runs; run++)
+        {
+            run_path(path, run_dir, pass, run);
+            unlink(path);
+        }
+    rmdir(run_dir);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    sort_stats.seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    if (stats != NULL)
+        *stats = sort_stats;
+    return result;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "workload.h"
+
+#define WORKLOAD_SORT_MEMORY (256UL << 20) /* default memory budget of sort_workload() */
+#define WORKLOAD_SORT_FAN_IN 64            /* runs merged at once, more take several passes */
+
+/**
+ * struct workload_sort_stats_s - What a sort_workload() did
+ * @count: processes sorted
+ * @runs: sorted runs written by the first phase
+ * @passes: merge passes over the runs, the last one writes the output
+ * @seconds: wall time of the whole sort
+ */
+typedef struct workload_sort_stats_s
+{
+    size_t count;
+    size_t runs;
+    int passes;
+    double seconds;
+} workload_sort_stats_t;
+
+/**
+ * is_workload_sorted - checks that the processes of a file arrive in order.
+ * @param file_path: path of the processes file, text or binary.
+ * @return 1 if it is sorted by arrival, 0 if not, -1 if it can not be read.
+ *
+ * Description: The file is streamed, reading stops at the first process out of order.
+ */
+int is_workload_sorted(const char *file_path);
+
+/**
+ * sort_workload - sorts a processes file by arrival with bounded memory.
+ * @param input_path: the file to sort, text or binary.
+ * @param output_path: the sorted file, it is truncated.
+ * @param format: format to write the sorted file in.
+ * @param memory: bytes of records held in memory at once.
+ * @param threads: threads sorting runs while the input is read.
+ * @param stats: filled with what the sort did, may be NULL.
+ * @return 0 on success, -1 on failure.
+ *
+ * Description: An external merge sort. The input is streamed into runs that fill the
+ *              memory budget; each run is radix sorted by a worker thread and written
+ *              as a binary workload while the next one is read. The runs are then
+ *              merged WORKLOAD_SORT_FAN_IN at a time until one pass writes the output.
+ *              The sort is stable, processes arriving at the same time keep their order.
+ *              Runs are written to a hidden directory next to @output_path.
+ */
+int sort_workload(const char *input_path, const char *output_path, workload_format format, size_t memory,
+                  int threads, workload_sort_stats_t *stats);